@@ -0,0 +1,142 @@
+#include "bitboard.h"
+
+// ---------------------------
+// Compile-time Table Generation
+// ---------------------------
+
+namespace {
+
+constexpr Bitboard stepBit(int row, int col, int dRow, int dCol) {
+    return (row + dRow >= 0 && row + dRow < 8 && col + dCol >= 0 && col + dCol < 8)
+        ? (Bitboard)1 << ((row + dRow) * 8 + col + dCol)
+        : 0;
+}
+
+constexpr Bitboard rayMask(int row, int col, int dRow, int dCol) {
+    Bitboard mask = 0;
+    for (int r = row + dRow, c = col + dCol; r >= 0 && r < 8 && c >= 0 && c < 8; r += dRow, c += dCol) {
+        mask |= (Bitboard)1 << (r * 8 + c);
+    }
+    return mask;
+}
+
+constexpr AttackTables buildAttackTables() {
+    AttackTables t{};
+    for (int sq = 0; sq < 64; sq++) {
+        int row = sq / 8;
+        int col = sq % 8;
+
+        t.ma[sq] = stepBit(row, col, 2, 1) | stepBit(row, col, 1, 2) | stepBit(row, col, -1, 2) |
+                   stepBit(row, col, -2, 1) | stepBit(row, col, -2, -1) | stepBit(row, col, -1, -2) |
+                   stepBit(row, col, 1, -2) | stepBit(row, col, 2, -1);
+
+        t.met[sq] = stepBit(row, col, 1, 1) | stepBit(row, col, 1, -1) |
+                    stepBit(row, col, -1, 1) | stepBit(row, col, -1, -1);
+
+        t.khun[sq] = t.met[sq] | stepBit(row, col, 1, 0) | stepBit(row, col, -1, 0) |
+                     stepBit(row, col, 0, 1) | stepBit(row, col, 0, -1);
+
+        // White moves towards row 7, Black towards row 0
+        for (int side = 0; side < 2; side++) {
+            int forward = (side == SIDE_WHITE) ? 1 : -1;
+            t.khon[side][sq] = t.met[sq] | stepBit(row, col, forward, 0);
+            t.biaPush[side][sq] = stepBit(row, col, forward, 0);
+            t.biaCapture[side][sq] = stepBit(row, col, forward, 1) | stepBit(row, col, forward, -1);
+        }
+
+        t.rays[RAY_NORTH][sq] = rayMask(row, col, 1, 0);
+        t.rays[RAY_EAST][sq] = rayMask(row, col, 0, 1);
+        t.rays[RAY_SOUTH][sq] = rayMask(row, col, -1, 0);
+        t.rays[RAY_WEST][sq] = rayMask(row, col, 0, -1);
+    }
+    return t;
+}
+
+} // namespace
+
+extern constexpr AttackTables ATTACK_TABLES = buildAttackTables();
+
+// ---------------------------
+// BoardBitboards Implementation
+// ---------------------------
+
+void BoardBitboards::clear() {
+    for (int side = 0; side < 2; side++) {
+        for (int type = 0; type < PIECE_TYPE_COUNT; type++) {
+            pieces[side][type] = 0;
+        }
+        bySide[side] = 0;
+    }
+    occupied = 0;
+}
+
+void BoardBitboards::loadFromBoard(const char board[8][8]) {
+    clear();
+    for (int row = 0; row < 8; row++) {
+        for (int col = 0; col < 8; col++) {
+            char piece = board[row][col];
+            if (piece == ' ') continue;
+
+            int type = pieceTypeFromChar(piece);
+            if (type == PIECE_NONE) continue;
+
+            int side = pieceSideFromChar(piece);
+            Bitboard bit = squareBit(squareIndex(row, col));
+            pieces[side][type] |= bit;
+            bySide[side] |= bit;
+        }
+    }
+    occupied = bySide[SIDE_WHITE] | bySide[SIDE_BLACK];
+}
+
+// ---------------------------
+// Move Generation
+// ---------------------------
+
+Bitboard pieceAttacks(int side, int type, int sq, Bitboard occupied) {
+    switch (type) {
+        case PIECE_BIA:  return ATTACK_TABLES.biaCapture[side][sq];
+        case PIECE_RUA:  return ruaAttacks(sq, occupied);
+        case PIECE_MA:   return ATTACK_TABLES.ma[sq];
+        case PIECE_KHON: return ATTACK_TABLES.khon[side][sq];
+        case PIECE_MET:  return ATTACK_TABLES.met[sq];
+        case PIECE_KHUN: return ATTACK_TABLES.khun[sq];
+    }
+    return 0;
+}
+
+Bitboard pseudoLegalMoves(const BoardBitboards &bb, int side, int type, int sq) {
+    if (type == PIECE_BIA) {
+        // Bia moves straight but captures diagonally
+        return (ATTACK_TABLES.biaPush[side][sq] & ~bb.occupied) |
+               (ATTACK_TABLES.biaCapture[side][sq] & bb.bySide[side ^ 1]);
+    }
+    return pieceAttacks(side, type, sq, bb.occupied) & ~bb.bySide[side];
+}
+
+// ---------------------------
+// Piece Letter Conversion
+// ---------------------------
+
+int pieceTypeFromChar(char piece) {
+    switch (piece) {
+        case 'P': case 'p': return PIECE_BIA;
+        case 'R': case 'r': return PIECE_RUA;
+        case 'N': case 'n': return PIECE_MA;
+        case 'B': case 'b': return PIECE_KHON;
+        case 'Q': case 'q': return PIECE_MET;
+        case 'K': case 'k': return PIECE_KHUN;
+    }
+    return PIECE_NONE;
+}
+
+int pieceSideFromChar(char piece) {
+    return (piece >= 'a' && piece <= 'z') ? SIDE_BLACK : SIDE_WHITE;
+}
+
+char pieceToChar(int side, int type) {
+    static const char letters[] = "PRNBQK";
+    if (type < 0 || type >= PIECE_TYPE_COUNT) return ' ';
+    char piece = letters[type];
+    return (side == SIDE_BLACK) ? piece + 32 : piece;
+}
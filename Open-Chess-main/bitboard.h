@@ -0,0 +1,112 @@
+#ifndef BITBOARD_H
+#define BITBOARD_H
+
+#include <stdint.h>
+
+// ---------------------------
+// Bitboard Types
+// ---------------------------
+// Square index is row * 8 + col, so bit 0 is a1 (row 0, col 0) and bit 63 is h8.
+typedef uint64_t Bitboard;
+
+enum Side {
+    SIDE_WHITE = 0,
+    SIDE_BLACK = 1
+};
+
+// Makruk piece types (board letters in brackets)
+enum PieceType {
+    PIECE_BIA = 0,   // Pawn (P)
+    PIECE_RUA = 1,   // Rook (R)
+    PIECE_MA = 2,    // Knight (N)
+    PIECE_KHON = 3,  // Bishop (B)
+    PIECE_MET = 4,   // Queen (Q)
+    PIECE_KHUN = 5,  // King (K)
+    PIECE_TYPE_COUNT = 6,
+    PIECE_NONE = 6
+};
+
+// Sliding directions used by the Rua ray tables
+enum RayDirection {
+    RAY_NORTH = 0,   // row + 1
+    RAY_EAST = 1,    // col + 1
+    RAY_SOUTH = 2,   // row - 1
+    RAY_WEST = 3     // col - 1
+};
+
+// ---------------------------
+// Square and Bit Helpers
+// ---------------------------
+inline int squareIndex(int row, int col) { return (row << 3) | col; }
+inline int squareRow(int sq) { return sq >> 3; }
+inline int squareCol(int sq) { return sq & 7; }
+inline Bitboard squareBit(int sq) { return (Bitboard)1 << sq; }
+
+inline int lsbIndex(Bitboard b) { return __builtin_ctzll(b); }
+inline int msbIndex(Bitboard b) { return 63 - __builtin_clzll(b); }
+inline int bitCount(Bitboard b) { return __builtin_popcountll(b); }
+
+// Remove and return the lowest set bit
+inline int popLsb(Bitboard &b) {
+    int sq = lsbIndex(b);
+    b &= b - 1;
+    return sq;
+}
+
+// ---------------------------
+// Precomputed Attack Tables
+// ---------------------------
+// Generated at compile time in bitboard.cpp (stored in flash on the RP2040).
+struct AttackTables {
+    Bitboard ma[64];            // Knight jumps
+    Bitboard khun[64];          // King steps (8 neighbours)
+    Bitboard met[64];           // Queen steps (1 diagonal)
+    Bitboard khon[2][64];       // Bishop steps (1 diagonal or 1 forward), per side
+    Bitboard biaPush[2][64];    // Pawn single push, per side
+    Bitboard biaCapture[2][64]; // Pawn diagonal captures, per side
+    Bitboard rays[4][64];       // Empty-board Rua rays, per RayDirection
+};
+
+extern const AttackTables ATTACK_TABLES;
+
+// Squares reached along one ray, stopping at (and including) the first blocker
+inline Bitboard rayAttacks(int dir, int sq, Bitboard occupied) {
+    Bitboard ray = ATTACK_TABLES.rays[dir][sq];
+    Bitboard blockers = ray & occupied;
+    if (blockers) {
+        int blocker = (dir == RAY_NORTH || dir == RAY_EAST) ? lsbIndex(blockers) : msbIndex(blockers);
+        ray ^= ATTACK_TABLES.rays[dir][blocker];
+    }
+    return ray;
+}
+
+inline Bitboard ruaAttacks(int sq, Bitboard occupied) {
+    return rayAttacks(RAY_NORTH, sq, occupied) | rayAttacks(RAY_EAST, sq, occupied) |
+           rayAttacks(RAY_SOUTH, sq, occupied) | rayAttacks(RAY_WEST, sq, occupied);
+}
+
+// ---------------------------
+// Board Bitboards
+// ---------------------------
+// Occupancy per side and per piece type, mirrored from a char[8][8] board.
+struct BoardBitboards {
+    Bitboard pieces[2][PIECE_TYPE_COUNT];
+    Bitboard bySide[2];
+    Bitboard occupied;
+
+    void clear();
+    void loadFromBoard(const char board[8][8]);
+};
+
+// Squares attacked by a piece (what it could capture on)
+Bitboard pieceAttacks(int side, int type, int sq, Bitboard occupied);
+
+// Pseudo-legal destination squares for the piece of the given side/type on sq
+Bitboard pseudoLegalMoves(const BoardBitboards &bb, int side, int type, int sq);
+
+// Piece letter conversion ('P','R','N','B','Q','K', lowercase for Black)
+int pieceTypeFromChar(char piece);
+int pieceSideFromChar(char piece);
+char pieceToChar(int side, int type);
+
+#endif // BITBOARD_H
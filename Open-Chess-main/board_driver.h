@@ -2,6 +2,10 @@
 #define BOARD_DRIVER_H
 
 #include <Adafruit_NeoPixel.h>
+#include "bitboard.h"
+#include "sensor_scanner.h"
+#include "profiler.h"
+#include "led_animator.h"
 
 // ---------------------------
 // Hardware Configuration
@@ -10,7 +14,7 @@
 #define NUM_ROWS    8
 #define NUM_COLS    8
 #define LED_COUNT   (NUM_ROWS * NUM_COLS)
-#define BRIGHTNESS  100
+#define BRIGHTNESS  100      // Default for setBrightness(), 0-255
 
 // Shift Register (74HC594) Pins
 #define SER_PIN     2   // Serial data input (74HC594 pin 14)
@@ -26,34 +30,86 @@
 class BoardDriver {
 private:
     Adafruit_NeoPixel strip;
-    int colPins[NUM_COLS];
-    byte rowPatterns[8];
-    bool sensorState[8][8];
-    bool sensorPrev[8][8];
+    SensorScanner scanner;      // Transport set by the constructor (GPIO, or simulated on the host)
+    Bitboard sensorBits;        // Occupancy from the last readSensors(), bit = row * 8 + col
+
+    LedCompositor leds;         // Layers, back buffer and the frame last pushed to the strip
+    LedAnimator animator;       // Draws on the effects layer of 'leds'
+    LedColorLut colorLut;       // Gamma and brightness, applied to each pixel as it is pushed
+    bool ledRepushAll;          // Brightness changed: every pixel needs new levels
+    uint32_t ledPushCount;      // Strip updates actually sent
     
-    void loadShiftRegister(byte data);
     int getPixelIndex(int row, int col);
 
 public:
     BoardDriver();
     void begin();
-    void readSensors();
-    bool getSensorState(int row, int col);
-    bool getSensorPrev(int row, int col);
-    void updateSensorPrev();
+    // Current occupancy (debounced), for checks of the whole board such as setup
+    void readSensors() { sensorBits = scanner.latestFrame(); }   // Never waits for the scan
+    bool getSensorState(int row, int col) { return (sensorBits >> squareIndex(row, col)) & 1; }
+    Bitboard getSensorBits() const { return sensorBits; }
+
+    // Lift/place events filled by the scanner, oldest first. Game modes drain
+    // these instead of comparing snapshots, so no change between polls is lost.
+    bool pollSensorEvent(SensorEvent &event) { return scanner.popEvent(event); }
+    void flushSensorEvents() { SensorEvent event; while (pollSensorEvent(event)) {} }
+    void setDebounceSamples(uint8_t samples) { scanner.setDebounceSamples(samples); }
+
+    // Scan engine
+    void setScanPeriod(unsigned long us) { scanner.setScanPeriod(us); }
+    uint32_t getFrameCount() const { return scanner.getFrameCount(); }
+    void waitForFrame() { scanner.waitForFrame(); }
     
-    // LED Control
-    void clearAllLEDs();
-    void setSquareLED(int row, int col, uint32_t color);
-    void setSquareLED(int row, int col, uint8_t r, uint8_t g, uint8_t b, uint8_t w = 0);
+    // LED Control. Setters only change layers; showLEDs() composes the layers,
+    // pushes the squares that differ from the last push and does nothing when none do.
+    // setSquareLED() draws on the base layer, clearAllLEDs() empties every layer.
+    void clearAllLEDs() { leds.clearAll(); }
+    void setSquareLED(int row, int col, uint32_t color) { leds.set(LED_LAYER_BASE, squareIndex(row, col), color); }
+    void setSquareLED(int row, int col, uint8_t r, uint8_t g, uint8_t b, uint8_t w = 0) {
+        setSquareLED(row, col, ledColor(r, g, b, w));
+    }
     void showLEDs();
+    void setBrightness(uint8_t value) { colorLut.setBrightness(value); ledRepushAll = true; }
+    uint8_t getBrightness() const { return colorLut.getBrightness(); }
+
+    // Layered drawing: a mode redraws only its own layer
+    void setLayerLED(LedLayer layer, int row, int col, uint32_t color) { leds.set(layer, squareIndex(row, col), color); }
+    void clearLayerLED(LedLayer layer, int row, int col) { leds.clear(layer, squareIndex(row, col)); }
+    void fillLayer(LedLayer layer, Bitboard squares, uint32_t color) { leds.fill(layer, squares, color); }
+    void clearLayer(LedLayer layer) { leds.clearLayer(layer); }
+    uint32_t getLEDPushCount() const { return ledPushCount; }
     
-    // Animation Functions
-    void fireworkAnimation();
-    void captureAnimation(int row, int col);
-    void promotionAnimation(int col);
-    void blinkSquare(int row, int col, int times = 3);
+    // Animation Functions. These start the animation and return at once; it runs
+    // on the effects layer while tick() is called, over whatever is drawn below.
+    AnimationId fireworkAnimation() { return animator.startFirework(millis()); }
+    AnimationId captureAnimation(int row, int col) { return animator.startCapture(row, col, millis()); }
+    AnimationId promotionAnimation(int col) { return animator.startPromotion(col, millis()); }
+    AnimationId blinkSquare(int row, int col, int times = 3, uint32_t color = LED_WHITE) { return animator.startBlink(row, col, times, millis(), color); }
+    void cancelAnimation(AnimationId id) { animator.cancel(id); }
+    bool isAnimating() const { return !animator.isIdle(); }
     void highlightSquare(int row, int col, uint32_t color);
+
+    // Advance the animations (and a loop-driven scan) and push the LEDs if
+    // anything changed. idle() is a delay() that keeps ticking. The main loop
+    // runs the two halves as separate scheduler tasks.
+    void pollSensors() {
+        scanner.poll();
+#if PROFILING_ENABLED
+        ProfileHistogram scanTiming;
+        scanner.takeTickTiming(scanTiming);
+        PROFILER.merge(PROFILE_SCAN_TICK, scanTiming);
+#endif
+    }
+    void refreshLEDs(unsigned long nowMs) {
+        animator.tick(nowMs);
+        showLEDs();
+    }
+    void tick(unsigned long nowMs) {
+        refreshLEDs(nowMs);
+        pollSensors();
+    }
+    void idle(unsigned long ms);
+    void waitForAnimations();   // Before something that blocks the loop (network requests)
     
     // Setup Functions
     bool checkInitialBoard(const char initialBoard[8][8]);
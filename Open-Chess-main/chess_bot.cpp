@@ -1,9 +1,11 @@
 #include "chess_bot.h"
 #include <Arduino.h>
+#include "profiler.h"
 
-ChessBot::ChessBot(BoardDriver* boardDriver, ChessEngine* chessEngine, BotDifficulty diff) {
+ChessBot::ChessBot(BoardDriver* boardDriver, ChessEngine* chessEngine, EngineWorker* engineWorker, BotDifficulty diff) {
     _boardDriver = boardDriver;
     _chessEngine = chessEngine;
+    _engineWorker = engineWorker;
     difficulty = diff;
     
     // Set difficulty settings
@@ -16,8 +18,22 @@ ChessBot::ChessBot(BoardDriver* boardDriver, ChessEngine* chessEngine, BotDiffic
     
     isWhiteTurn = true;
     gameStarted = false;
+    setupPending = false;
+    lastSetupCheck = 0;
     botThinking = false;
+    botMovePending = false;
+    searchRetry = false;
+    botMoveOnBoard = false;
+    botMove = MOVE_NONE;
+    botExpectedReply = MOVE_NONE;
+    botPiecePickedUp = false;
+    botMoveBlinkOn = false;
+    lastBotMoveBlink = 0;
     wifiConnected = false;
+    searchJobId = 0;
+    ponderJobId = 0;
+    ponderKey = 0;
+    clearResponseCache();
 }
 
 void ChessBot::begin() {
@@ -51,17 +67,16 @@ void ChessBot::begin() {
             // Light up entire board green briefly
             for (int row = 0; row < 8; row++) {
                 for (int col = 0; col < 8; col++) {
-                    _boardDriver->setSquareLED(row, col, 0, 255, 0); // Green
+                    _boardDriver->setSquareLED(row, col, LED_CONFIRM); // Green
                 }
             }
             _boardDriver->showLEDs();
             delay(200);
         }
         
-        initializeBoard();
-        waitForBoardSetup();
+        startBoardSetup();
     } else {
-        Serial.println("Failed to connect to WiFi. Bot mode unavailable.");
+        Serial.println("Failed to connect to WiFi. Playing against the on-device engine.");
         wifiConnected = false;
         
         // Show error animation (red flashing)
@@ -73,7 +88,7 @@ void ChessBot::begin() {
             // Light up entire board red briefly
             for (int row = 0; row < 8; row++) {
                 for (int col = 0; col < 8; col++) {
-                    _boardDriver->setSquareLED(row, col, 255, 0, 0); // Red
+                    _boardDriver->setSquareLED(row, col, LED_ILLEGAL); // Red
                 }
             }
             _boardDriver->showLEDs();
@@ -82,24 +97,27 @@ void ChessBot::begin() {
         
         _boardDriver->clearAllLEDs();
         _boardDriver->showLEDs();
+        
+        startBoardSetup();
     }
 }
 
 void ChessBot::update() {
-    if (!wifiConnected) {
-        return; // No WiFi, can't play against bot
-    }
-    
     if (!gameStarted) {
-        return; // Waiting for initial setup
+        // Wait for the start position without holding up the loop
+        if (setupPending && millis() - lastSetupCheck >= BOT_SETUP_CHECK_MS) {
+            lastSetupCheck = millis();
+            if (checkBoardSetup()) setupPending = false;
+        }
+        return;
     }
-    
-    if (botThinking) {
-        showBotThinking();
+    if (botMoveOnBoard) {
+        updateBotMoveOnBoard();
         return;
     }
-    
-    _boardDriver->readSensors();
+    if (botThinking) {
+        return; // The bot's turn (see updateEngine())
+    }
     
     // Detect piece movements (player's turn - White pieces only)
     if (isWhiteTurn) {
@@ -108,149 +126,108 @@ void ChessBot::update() {
             Serial.println("Your turn! Move a WHITE piece (uppercase letters)");
             lastTurnDebug = millis();
         }
-        // Look for piece pickups and placements
-        static int selectedRow = -1, selectedCol = -1;
-        static bool piecePickedUp = false;
-        
-        // Check for piece pickup
-        if (!piecePickedUp) {
-            for (int row = 0; row < 8; row++) {
-                for (int col = 0; col < 8; col++) {
-                    if (!_boardDriver->getSensorState(row, col) && _boardDriver->getSensorPrev(row, col)) {
-                        // Check what piece was picked up
-                        char piece = board[row][col];
-                        
-                        if (piece != ' ') {
-                            // Player should only be able to move White pieces (uppercase)
-                            if (piece >= 'A' && piece <= 'Z') {
-                            selectedRow = row;
-                            selectedCol = col;
-                            piecePickedUp = true;
-                            
-                            Serial.print("Player picked up WHITE piece '");
-                            Serial.print(board[row][col]);
-                            Serial.print("' at ");
-                            Serial.print((char)('a' + col));
-                            Serial.print(8 - row);
-                            Serial.print(" (array position ");
-                            Serial.print(row);
-                            Serial.print(",");
-                            Serial.print(col);
-                            Serial.println(")");
-                            
-                            // Show selected square
-                            _boardDriver->setSquareLED(row, col, 255, 0, 0); // Red
-                            
-                            // Show possible moves
-                            int moveCount = 0;
-                            int moves[27][2];
-                            _chessEngine->getPossibleMoves(board, row, col, moveCount, moves);
-                            
-                            for (int i = 0; i < moveCount; i++) {
-                                _boardDriver->setSquareLED(moves[i][0], moves[i][1], 255, 255, 255); // White
-                            }
-                            _boardDriver->showLEDs();
-                            break;
-                            } else {
-                                // Player tried to pick up a Black piece - not allowed!
-                                Serial.print("ERROR: You tried to pick up BLACK piece '");
-                                Serial.print(piece);
-                                Serial.print("' at ");
-                                Serial.print((char)('a' + col));
-                                Serial.print(8 - row);
-                                Serial.println(". You can only move WHITE pieces!");
-                                
-                                // Flash red to indicate error
-                                _boardDriver->blinkSquare(row, col, 3);
-                            }
-                        }
-                    }
+        // Lifts and placements go through the recognizer: it confirms the
+        // move (captures in either order) or shows what fits no move
+        SensorEvent event;
+        while (isWhiteTurn && _boardDriver->pollSensorEvent(event)) {
+            int previousOrigin = recognizer.getOrigin();
+            RecognizerStatus status = recognizer.onEvent(event);
+            int row = squareRow(event.square);
+            int col = squareCol(event.square);
+            
+            if (status == RECOGNIZER_MOVE) {
+                Move move = recognizer.getMove();
+                int fromRow = squareRow(moveFrom(move));
+                int fromCol = squareCol(moveFrom(move));
+                int toRow = squareRow(moveTo(move));
+                int toCol = squareCol(moveTo(move));
+                char piece = board[fromRow][fromCol];
+                _boardDriver->clearLayer(LED_LAYER_MOVES);
+                _boardDriver->clearLayer(LED_LAYER_HINTS);
+                _boardDriver->clearLayer(LED_LAYER_ALERTS);
+                
+                // Complete LED animations BEFORE API request
+                processPlayerMove(fromRow, fromCol, toRow, toCol, piece);
+                
+                // Flash confirmation on destination square for player move
+                confirmSquareCompletion(toRow, toCol);
+                
+                // Mate or draw: the bot has nothing to answer
+                if (checkGameEnd()) return;
+                
+                // Switch to bot's turn; updateEngine() starts the calculation
+                isWhiteTurn = false;
+                botThinking = true;
+                botMovePending = true;
+                
+                Serial.println("Player move completed. Bot thinking...");
+            } else if (status == RECOGNIZER_SETTLED) {
+                if (event.type == SENSOR_PLACE && event.square == previousOrigin) {
+                    Serial.println("Piece returned to original position. Selection cancelled.");
                 }
-                if (piecePickedUp) break;
-            }
-        }
-        
-        // Check for piece placement
-        if (piecePickedUp) {
-            for (int row = 0; row < 8; row++) {
-                for (int col = 0; col < 8; col++) {
-                    if (_boardDriver->getSensorState(row, col) && !_boardDriver->getSensorPrev(row, col)) {
-                        // Check if piece was returned to its original position
-                        if (row == selectedRow && col == selectedCol) {
-                            // Piece returned to original position - cancel selection
-                            Serial.println("Piece returned to original position. Selection cancelled.");
-                            piecePickedUp = false;
-                            selectedRow = selectedCol = -1;
-                            
-                            // Clear all indicators
-                            _boardDriver->clearAllLEDs();
-                            _boardDriver->showLEDs();
-                            break;
-                        }
-                        
-                        // Piece placed somewhere else - validate move
-                        int moveCount = 0;
-                        int moves[27][2];
-                        _chessEngine->getPossibleMoves(board, selectedRow, selectedCol, moveCount, moves);
-                        
-                        bool validMove = false;
-                        for (int i = 0; i < moveCount; i++) {
-                            if (moves[i][0] == row && moves[i][1] == col) {
-                                validMove = true;
-                                break;
-                            }
-                        }
-                        
-                        if (validMove) {
-                            char piece = board[selectedRow][selectedCol];
-                            
-                            // Complete LED animations BEFORE API request
-                            processPlayerMove(selectedRow, selectedCol, row, col, piece);
-                            
-                            // Flash confirmation on destination square for player move
-                            confirmSquareCompletion(row, col);
-                            
-                            piecePickedUp = false;
-                            selectedRow = selectedCol = -1;
-                            
-                            // Switch to bot's turn
-                            isWhiteTurn = false;
-                            botThinking = true;
-                            
-                            Serial.println("Player move completed. Bot thinking...");
-                            
-                            // Start bot move calculation
-                            makeBotMove();
-                        } else {
-                            Serial.println("Invalid move! Please try again.");
-                            _boardDriver->blinkSquare(row, col, 3); // Blink red for invalid move
-                            
-                            // Restore move indicators - piece is still selected
-                            _boardDriver->clearAllLEDs();
-                            
-                            // Show selected square again
-                            _boardDriver->setSquareLED(selectedRow, selectedCol, 255, 0, 0); // Red
-                            
-                            // Show possible moves again
-                            int moveCount = 0;
-                            int moves[27][2];
-                            _chessEngine->getPossibleMoves(board, selectedRow, selectedCol, moveCount, moves);
-                            
-                            for (int i = 0; i < moveCount; i++) {
-                                _boardDriver->setSquareLED(moves[i][0], moves[i][1], 255, 255, 255); // White
-                            }
-                            _boardDriver->showLEDs();
-                            
-                            Serial.println("Piece is still selected. Place it on a valid move or return it to its original position.");
-                        }
-                        break;
+                
+                // Clear all indicators
+                _boardDriver->clearLayer(LED_LAYER_MOVES);
+                _boardDriver->clearLayer(LED_LAYER_HINTS);
+                _boardDriver->clearLayer(LED_LAYER_ALERTS);
+                _boardDriver->showLEDs();
+            } else {
+                int origin = recognizer.getOrigin();
+                if (origin >= 0 && origin != previousOrigin) {
+                    Serial.print("Player picked up WHITE piece '");
+                    Serial.print(board[squareRow(origin)][squareCol(origin)]);
+                    Serial.print("' at ");
+                    Serial.print((char)('a' + squareCol(origin)));
+                    Serial.println(8 - squareRow(origin));
+                }
+                if (recognizer.getMisplaced() & squareBit(event.square)) {
+                    if (event.type == SENSOR_LIFT) {
+                        // Player tried to pick up a Black piece - not allowed!
+                        Serial.print("ERROR: You tried to pick up BLACK piece '");
+                        Serial.print(board[row][col]);
+                        Serial.print("' at ");
+                        Serial.print((char)('a' + col));
+                        Serial.print(8 - row);
+                        Serial.println(". You can only move WHITE pieces!");
+                    } else {
+                        Serial.println("Invalid move! Please try again.");
+                        Serial.println("Place the piece on a valid move or return it to its original position.");
                     }
                 }
+                showPickupLEDs();
             }
         }
+        
+    }
+}
+
+// The bot's side of the game: Stockfish request or engine search, the
+// thinking indicator, and pondering on a single core. Runs as its own task
+// next to update(), so network and search time are accounted separately.
+void ChessBot::updateEngine() {
+    if (!gameStarted) {
+        return;
+    }
+    
+    if (botMovePending) {
+        botMovePending = false;
+        makeBotMove();
+        return;
     }
     
-    _boardDriver->updateSensorPrev();
+    if (botThinking) {
+#if !ENGINE_WORKER_DUAL_CORE
+        _engineWorker->step(ENGINE_PONDER_SLICE_MS);
+#endif
+        handleEngineReply();
+        if (botThinking) showBotThinking();
+        return;
+    }
+    
+#if !ENGINE_WORKER_DUAL_CORE
+    // No second core: ponder in slices between sensor polls
+    if (isWhiteTurn) _engineWorker->step(ENGINE_PONDER_SLICE_MS);
+#endif
 }
 
 bool ChessBot::connectToWiFi() {
@@ -287,6 +264,7 @@ bool ChessBot::connectToWiFi() {
 }
 
 String ChessBot::makeStockfishRequest(String fen) {
+    PROFILE_SCOPE(PROFILE_STOCKFISH_REQUEST);
     WiFiSSLClient client;
     
     Serial.println("Making API request to Stockfish...");
@@ -393,40 +371,197 @@ bool ChessBot::parseStockfishResponse(String response, String &bestMove) {
 }
 
 void ChessBot::makeBotMove() {
+    if (searchRetry) {
+        // The engine queue was full last time: only the submit is retried
+        if (startLocalSearch()) searchRetry = false;
+        else botMovePending = true;
+        return;
+    }
+    
     Serial.println("=== BOT MOVE CALCULATION ===");
     Serial.print("Bot is playing as: ");
     Serial.println(isWhiteTurn ? "White" : "Black");
+    
+    ZobristKey key = position.getHashKey();
+    int fromRow, fromCol, toRow, toCol;
+    bool found = false;
+    
+    if (lookupCachedMove(key, fromRow, fromCol, toRow, toCol)) {
+        Serial.println("Position found in response cache - skipping Stockfish request");
+        found = true;
+    } else if (wifiConnected) {
+        // The HTTP request holds up the loop: let the move animations finish first
+        _boardDriver->waitForAnimations();
+        if (requestStockfishMove(fromRow, fromCol, toRow, toCol)) {
+            storeCachedMove(key, fromRow, fromCol, toRow, toCol);
+            found = true;
+        }
+    }
+    
+    if (found) {
+        stopPondering();
+        botThinking = false;
+        executeBotMove(fromRow, fromCol, toRow, toCol);
+        return;
+    }
+    
+    // Offline, or Stockfish failed: the engine core thinks while update()
+    // keeps the thinking animation going, see handleEngineReply()
+    if (!startLocalSearch()) {
+        // Job queue full: stay on the bot's turn, updateEngine() tries again
+        Serial.println("Engine busy - retrying the bot move");
+        searchRetry = true;
+        botMovePending = true;
+    }
+}
+
+bool ChessBot::requestStockfishMove(int &fromRow, int &fromCol, int &toRow, int &toCol) {
     Serial.print("Current board state (FEN): ");
     
     String fen = boardToFEN();
     String response = makeStockfishRequest(fen);
     
-    if (response.length() > 0) {
-        String bestMove;
-        if (parseStockfishResponse(response, bestMove)) {
-            int fromRow, fromCol, toRow, toCol;
-            if (parseMove(bestMove, fromRow, fromCol, toRow, toCol)) {
-                Serial.print("Bot move: ");
-                Serial.println(bestMove);
-                
-                executeBotMove(fromRow, fromCol, toRow, toCol);
-                
-                // Switch back to player's turn
-                isWhiteTurn = true;
-                botThinking = false;
-                
-                Serial.println("Bot move completed. Your turn!");
-            } else {
-                Serial.println("Failed to parse bot move");
-                botThinking = false;
-            }
-        } else {
-            Serial.println("Failed to parse Stockfish response");
-            botThinking = false;
-        }
-    } else {
+    if (response.length() == 0) {
         Serial.println("No response from Stockfish API");
-        botThinking = false;
+        return false;
+    }
+    
+    String bestMove;
+    if (!parseStockfishResponse(response, bestMove)) {
+        Serial.println("Failed to parse Stockfish response");
+        return false;
+    }
+    
+    if (!parseMove(bestMove, fromRow, fromCol, toRow, toCol)) {
+        Serial.println("Failed to parse bot move");
+        return false;
+    }
+    
+    // Stockfish plays standard chess, so its answer may not be a Makruk move
+    if (!position.isLegal(position.createMove(squareIndex(fromRow, fromCol), squareIndex(toRow, toCol)))) {
+        Serial.print("Stockfish move is not legal in Makruk: ");
+        Serial.println(bestMove);
+        return false;
+    }
+    
+    Serial.print("Bot move: ");
+    Serial.println(bestMove);
+    return true;
+}
+
+// ---------------------------
+// Engine Worker Jobs
+// ---------------------------
+
+bool ChessBot::startLocalSearch() {
+    // Same depth and time limits as the Stockfish request for this difficulty
+    SearchLimits limits = searchLimitsFor(settings);
+    
+    if (ponderJobId != 0 && position.getHashKey() == ponderKey) {
+        // The player made the expected move: the ponder job becomes the answer
+        Serial.println("Ponder hit - the engine has been thinking about this move");
+        searchJobId = ponderJobId;
+        ponderJobId = 0;
+        return true;
+    }
+    
+    if (ponderJobId != 0) Serial.println("Ponder miss");
+    stopPondering();
+    
+    Serial.println("Searching with the on-device engine...");
+    searchJobId = _engineWorker->submit(ENGINE_JOB_SEARCH, position, limits);
+    return searchJobId != 0;
+}
+
+void ChessBot::handleEngineReply() {
+    EngineReply reply;
+    if (!_engineWorker->poll(reply)) return;
+    if (reply.id != searchJobId) return;  // Cancelled ponder job
+    searchJobId = 0;
+    
+    const SearchResult &result = reply.result;
+    if (result.bestMove == MOVE_NONE) {
+        // Mate and stalemate end the game after the player's move, so this
+        // is a search that found nothing in time: ask again
+        Serial.println("Bot has no move - searching again");
+        if (!checkGameEnd()) botMovePending = true;
+        return;
+    }
+    
+    Serial.print("Local engine: depth ");
+    Serial.print(result.depth);
+    Serial.print(", score ");
+    Serial.print(result.score);
+    Serial.print(", ");
+    Serial.print(result.nodes);
+    Serial.print(" nodes in ");
+    Serial.print(result.elapsedMs);
+    Serial.print(" ms (");
+    switch (result.stopReason) {
+        case SEARCH_STOP_DEPTH: Serial.print("depth limit"); break;
+        case SEARCH_STOP_TIME: Serial.print("time limit"); break;
+        case SEARCH_STOP_EASY_MOVE: Serial.print("clear best move"); break;
+        case SEARCH_STOP_MATE: Serial.print("forced mate"); break;
+        case SEARCH_STOP_ONLY_MOVE: Serial.print("only move"); break;
+        case SEARCH_STOP_ABORTED: Serial.print("aborted"); break;
+    }
+    Serial.println(")");
+    printTTStats(reply.hashStats);
+    
+    botThinking = false;
+    executeBotMove(squareRow(moveFrom(result.bestMove)), squareCol(moveFrom(result.bestMove)),
+                   squareRow(moveTo(result.bestMove)), squareCol(moveTo(result.bestMove)), reply.expectedReply);
+}
+
+// Search the position after the player's expected reply while they think.
+// Only done when the local engine is the opponent.
+void ChessBot::startPondering(Move expected) {
+    if (wifiConnected || expected == MOVE_NONE || !position.isLegal(expected)) return;
+    
+    // Played on the game position and taken back once the job is queued
+    position.makeMove(expected);
+    if (position.hasLegalMove()) {  // Otherwise the game is over after that reply
+        ponderKey = position.getHashKey();
+        ponderJobId = _engineWorker->submit(ENGINE_JOB_PONDER, position, searchLimitsFor(settings));
+    }
+    position.unmakeMove();
+    if (ponderJobId == 0) return;
+    
+    Serial.print("Pondering on expected reply ");
+    _chessEngine->printMove(squareRow(moveFrom(expected)), squareCol(moveFrom(expected)),
+                            squareRow(moveTo(expected)), squareCol(moveTo(expected)));
+}
+
+void ChessBot::stopPondering() {
+    if (ponderJobId == 0) return;
+    _engineWorker->cancel(ponderJobId);
+    ponderJobId = 0;
+}
+
+bool ChessBot::lookupCachedMove(ZobristKey key, int &fromRow, int &fromCol, int &toRow, int &toCol) {
+    const CachedResponse &entry = responseCache[key & (BOT_RESPONSE_CACHE_SIZE - 1)];
+    if (entry.move == MOVE_NONE || entry.key != key) return false;
+    
+    // Guard against a stale entry that no longer fits the position
+    if (!position.isLegal(entry.move)) return false;
+    
+    fromRow = squareRow(moveFrom(entry.move));
+    fromCol = squareCol(moveFrom(entry.move));
+    toRow = squareRow(moveTo(entry.move));
+    toCol = squareCol(moveTo(entry.move));
+    return true;
+}
+
+void ChessBot::storeCachedMove(ZobristKey key, int fromRow, int fromCol, int toRow, int toCol) {
+    CachedResponse &entry = responseCache[key & (BOT_RESPONSE_CACHE_SIZE - 1)];
+    entry.key = key;
+    entry.move = encodeMove(squareIndex(fromRow, fromCol), squareIndex(toRow, toCol));
+}
+
+void ChessBot::clearResponseCache() {
+    for (int i = 0; i < BOT_RESPONSE_CACHE_SIZE; i++) {
+        responseCache[i].key = 0;
+        responseCache[i].move = MOVE_NONE;
     }
 }
 
@@ -463,8 +598,8 @@ String ChessBot::boardToFEN() {
     Serial.println(isWhiteTurn ? "White (w)" : "Black (b)");
     Serial.print("Bot should be playing as: Black");
     
-    // Castling availability (simplified - assume all available initially)
-    fen += " KQkq";
+    // Castling availability (Makruk has no castling)
+    fen += " -";
     
     // En passant target square (simplified - assume none)
     fen += " -";
@@ -521,14 +656,8 @@ bool ChessBot::parseMove(String move, int &fromRow, int &fromCol, int &toRow, in
             toRow >= 0 && toRow < 8 && toCol >= 0 && toCol < 8);
 }
 
-void ChessBot::executeBotMove(int fromRow, int fromCol, int toRow, int toCol) {
-    char piece = board[fromRow][fromCol];
-    char capturedPiece = board[toRow][toCol];
-    
-    // Update board state
-    board[toRow][toCol] = piece;
-    board[fromRow][fromCol] = ' ';
-    
+// Show the bot's move; update() waits for the player to copy it onto the board
+void ChessBot::executeBotMove(int fromRow, int fromCol, int toRow, int toCol, Move expectedReply) {
     Serial.print("Bot wants to move piece from ");
     Serial.print((char)('a' + fromCol));
     Serial.print(8 - fromRow);
@@ -540,8 +669,33 @@ void ChessBot::executeBotMove(int fromRow, int fromCol, int toRow, int toCol) {
     // Show the move that needs to be made
     showBotMoveIndicator(fromRow, fromCol, toRow, toCol);
     
-    // Wait for user to physically complete the bot's move
-    waitForBotMoveCompletion(fromRow, fromCol, toRow, toCol);
+    // Only this move is accepted; the player's captured piece may come off
+    // before or after the bot's piece is picked up
+    botMove = position.createMove(squareIndex(fromRow, fromCol), squareIndex(toRow, toCol));
+    botExpectedReply = expectedReply;
+    recognizer.sync(0, botMove);
+    botMoveOnBoard = true;
+    botPiecePickedUp = false;
+    botMoveBlinkOn = false;
+    lastBotMoveBlink = millis();
+    
+    Serial.println("Waiting for you to complete the bot's move...");
+}
+
+// The bot's move is on the board: play it, then it is the player's turn
+void ChessBot::finishBotMove() {
+    int fromRow = squareRow(moveFrom(botMove));
+    int fromCol = squareCol(moveFrom(botMove));
+    int toRow = squareRow(moveTo(botMove));
+    int toCol = squareCol(moveTo(botMove));
+    char capturedPiece = board[toRow][toCol];
+    botMoveOnBoard = false;
+    
+    // Update board state, then it is White's turn on the recognizer too
+    position.setSideToMove(pieceSideFromChar(board[fromRow][fromCol]));
+    position.makeMove(botMove);
+    position.toBoard(board);
+    recognizer.sync(position.bitboards().bySide[SIDE_WHITE]);
     
     if (capturedPiece != ' ') {
         Serial.print("Piece captured: ");
@@ -553,6 +707,11 @@ void ChessBot::executeBotMove(int fromRow, int fromCol, int toRow, int toCol) {
     confirmSquareCompletion(toRow, toCol);
     
     Serial.println("Bot move completed. Your turn!");
+    if (checkGameEnd()) return;
+    
+    // Switch back to player's turn
+    isWhiteTurn = true;
+    startPondering(botExpectedReply);
 }
 
 void ChessBot::showBotThinking() {
@@ -561,14 +720,13 @@ void ChessBot::showBotThinking() {
     
     if (millis() - lastUpdate > 500) {
         // Animated thinking indicator - pulse the corners
-        _boardDriver->clearAllLEDs();
-        
         uint8_t brightness = (sin(thinkingStep * 0.3) + 1) * 127;
         
-        _boardDriver->setSquareLED(0, 0, 0, 0, brightness); // Corner LEDs pulse blue
-        _boardDriver->setSquareLED(0, 7, 0, 0, brightness);
-        _boardDriver->setSquareLED(7, 0, 0, 0, brightness);
-        _boardDriver->setSquareLED(7, 7, 0, 0, brightness);
+        _boardDriver->clearLayer(LED_LAYER_HINTS);
+        _boardDriver->setLayerLED(LED_LAYER_HINTS, 0, 0, ledColor(0, 0, brightness)); // Corner LEDs pulse blue
+        _boardDriver->setLayerLED(LED_LAYER_HINTS, 0, 7, ledColor(0, 0, brightness));
+        _boardDriver->setLayerLED(LED_LAYER_HINTS, 7, 0, ledColor(0, 0, brightness));
+        _boardDriver->setLayerLED(LED_LAYER_HINTS, 7, 7, ledColor(0, 0, brightness));
         
         _boardDriver->showLEDs();
         
@@ -580,7 +738,7 @@ void ChessBot::showBotThinking() {
 void ChessBot::showConnectionStatus() {
     // Show WiFi connection attempt with animated LEDs
     for (int i = 0; i < 8; i++) {
-        _boardDriver->setSquareLED(3, i, 0, 0, 255); // Blue row
+        _boardDriver->setSquareLED(3, i, LED_BLUE); // Blue row
         _boardDriver->showLEDs();
         delay(200);
     }
@@ -593,32 +751,91 @@ void ChessBot::initializeBoard() {
             board[row][col] = INITIAL_BOARD[row][col];
         }
     }
+    position.setFromBoard(INITIAL_BOARD, SIDE_WHITE);
 }
 
-void ChessBot::waitForBoardSetup() {
+// Before a game: update() checks the board until the start position is on it
+void ChessBot::startBoardSetup() {
+    initializeBoard();
     Serial.println("Please set up the chess board in starting position...");
-    
-    while (!_boardDriver->checkInitialBoard(INITIAL_BOARD)) {
-        _boardDriver->readSensors();
+    gameStarted = false;
+    setupPending = true;
+    lastSetupCheck = millis() - BOT_SETUP_CHECK_MS;  // First check right away
+}
+
+// One look at the board: shows what is still missing, or starts the game
+// once the start position is complete
+bool ChessBot::checkBoardSetup() {
+    _boardDriver->readSensors();
+    if (!_boardDriver->checkInitialBoard(INITIAL_BOARD)) {
         _boardDriver->updateSetupDisplay(INITIAL_BOARD);
         _boardDriver->showLEDs();
-        delay(100);
+        return false;
     }
     
     Serial.println("Board setup complete! Game starting...");
     _boardDriver->fireworkAnimation();
+    _boardDriver->flushSensorEvents();  // Setting up the pieces is not a move
+    _boardDriver->readSensors();
+    recognizer.begin(&position, _boardDriver->getSensorBits());
+    recognizer.sync(position.bitboards().bySide[SIDE_WHITE]);
     gameStarted = true;
     
     // Show initial board state
     printCurrentBoard();
+    return true;
+}
+
+// After each move: mate, stalemate or repetition ends the game (checked for
+// the side to move, which may be the bot or the player)
+bool ChessBot::checkGameEnd() {
+    bool botToMove = (position.getSideToMove() == SIDE_BLACK);
+    
+    if (position.isCheckmate()) {
+        Serial.print("Checkmate! ");
+        Serial.println(botToMove ? "You win" : "Bot wins");
+        _boardDriver->fireworkAnimation();
+    } else if (position.isStalemate()) {
+        Serial.println("Stalemate! The game is a draw");
+    } else if (position.repetitionCount() >= 2) {
+        Serial.println("Threefold repetition! The game is a draw");
+    } else {
+        return false;
+    }
+    
+    endGame();
+    return true;
+}
+
+// Back to setup: nobody is to move until the start position is on the board
+void ChessBot::endGame() {
+    stopPondering();
+    if (searchJobId != 0) {
+        _engineWorker->cancel(searchJobId);
+        searchJobId = 0;
+    }
+    botThinking = false;
+    botMovePending = false;
+    searchRetry = false;
+    botMoveOnBoard = false;
+    isWhiteTurn = true;
+    
+    _boardDriver->clearLayer(LED_LAYER_MOVES);
+    _boardDriver->clearLayer(LED_LAYER_HINTS);
+    _boardDriver->clearLayer(LED_LAYER_ALERTS);
+    _boardDriver->showLEDs();
+    
+    Serial.println("Game over - set up the board for a new game");
+    startBoardSetup();
 }
 
 void ChessBot::processPlayerMove(int fromRow, int fromCol, int toRow, int toCol, char piece) {
     char capturedPiece = board[toRow][toCol];
     
-    // Update board state
-    board[toRow][toCol] = piece;
-    board[fromRow][fromCol] = ' ';
+    // Update board state (the position applies promotion itself)
+    position.setSideToMove(pieceSideFromChar(piece));
+    position.makeMove(position.createMove(squareIndex(fromRow, fromCol), squareIndex(toRow, toCol)));
+    position.toBoard(board);
     
     Serial.print("Player moved ");
     Serial.print(piece);
@@ -637,10 +854,8 @@ void ChessBot::processPlayerMove(int fromRow, int fromCol, int toRow, int toCol,
     
     // Check for pawn promotion
     if (_chessEngine->isPawnPromotion(piece, toRow)) {
-        char promotedPiece = _chessEngine->getPromotedPiece(piece);
-        board[toRow][toCol] = promotedPiece;
         Serial.print("Pawn promoted to ");
-        Serial.println(promotedPiece);
+        Serial.println(board[toRow][toCol]);
         _boardDriver->promotionAnimation(toCol);
     }
 }
@@ -677,98 +892,88 @@ String ChessBot::urlEncode(String str) {
     return encoded;
 }
 
+// Lifted piece: its square on the hint layer, its legal moves on the moves
+// layer, anything that fits no move on the alert layer
+void ChessBot::showPickupLEDs() {
+    _boardDriver->clearLayer(LED_LAYER_HINTS);
+    int origin = recognizer.getOrigin();
+    if (origin >= 0) {
+        _boardDriver->setLayerLED(LED_LAYER_HINTS, squareRow(origin), squareCol(origin), LED_SELECTED);
+    }
+
+    _boardDriver->clearLayer(LED_LAYER_MOVES);
+    _boardDriver->fillLayer(LED_LAYER_MOVES, recognizer.getTargets(), LED_RGB_WHITE);
+
+    _boardDriver->clearLayer(LED_LAYER_ALERTS);
+    _boardDriver->fillLayer(LED_LAYER_ALERTS, recognizer.getMisplaced(), LED_ILLEGAL);
+    _boardDriver->showLEDs();
+}
+
 void ChessBot::showBotMoveIndicator(int fromRow, int fromCol, int toRow, int toCol) {
-    // Clear all LEDs first
-    _boardDriver->clearAllLEDs();
+    // Replace whatever hint was up (thinking indicator)
+    _boardDriver->clearLayer(LED_LAYER_HINTS);
     
     // Show source square flashing (where to pick up from)
-    _boardDriver->setSquareLED(fromRow, fromCol, 255, 255, 255); // White flashing
+    _boardDriver->setLayerLED(LED_LAYER_HINTS, fromRow, fromCol, LED_BOT_MOVE); // Flashing
     
     // Show destination square solid (where to place)
-    _boardDriver->setSquareLED(toRow, toCol, 255, 255, 255);     // White solid
+    _boardDriver->setLayerLED(LED_LAYER_HINTS, toRow, toCol, LED_BOT_MOVE);     // Solid
     
     _boardDriver->showLEDs();
 }
 
-void ChessBot::waitForBotMoveCompletion(int fromRow, int fromCol, int toRow, int toCol) {
-    bool piecePickedUp = false;
-    bool moveCompleted = false;
-    static unsigned long lastBlink = 0;
-    static bool blinkState = false;
-    
-    Serial.println("Waiting for you to complete the bot's move...");
-    
-    while (!moveCompleted) {
-        _boardDriver->readSensors();
-        
-        // Blink the source square
-        if (millis() - lastBlink > 500) {
-            _boardDriver->clearAllLEDs();
-            if (blinkState && !piecePickedUp) {
-                _boardDriver->setSquareLED(fromRow, fromCol, 255, 255, 255); // Flash source
-            }
-            _boardDriver->setSquareLED(toRow, toCol, 255, 255, 255);         // Always show destination
-            _boardDriver->showLEDs();
-            
-            blinkState = !blinkState;
-            lastBlink = millis();
+// Bot move waiting to be copied: blink its origin until the piece is lifted,
+// keep its destination lit, and show anything that does not fit the move
+void ChessBot::updateBotMoveOnBoard() {
+    int fromRow = squareRow(moveFrom(botMove));
+    int fromCol = squareCol(moveFrom(botMove));
+    
+    if (millis() - lastBotMoveBlink > BOT_MOVE_BLINK_MS) {
+        if (botMoveBlinkOn && !botPiecePickedUp) {
+            _boardDriver->setLayerLED(LED_LAYER_HINTS, fromRow, fromCol, LED_BOT_MOVE); // Flash source
+        } else {
+            _boardDriver->clearLayerLED(LED_LAYER_HINTS, fromRow, fromCol);
         }
+        _boardDriver->setLayerLED(LED_LAYER_HINTS, squareRow(moveTo(botMove)), squareCol(moveTo(botMove)), LED_BOT_MOVE);
+        _boardDriver->showLEDs();
+        
+        botMoveBlinkOn = !botMoveBlinkOn;
+        lastBotMoveBlink = millis();
+    }
+    
+    SensorEvent event;
+    while (botMoveOnBoard && _boardDriver->pollSensorEvent(event)) {
+        RecognizerStatus status = recognizer.onEvent(event);
         
         // Check if piece was picked up from source
-        if (!piecePickedUp && !_boardDriver->getSensorState(fromRow, fromCol)) {
-            piecePickedUp = true;
+        if (!botPiecePickedUp && recognizer.getOrigin() >= 0) {
+            botPiecePickedUp = true;
             Serial.println("Bot piece picked up, now place it on the destination...");
             
             // Stop blinking source, just show destination
-            _boardDriver->clearAllLEDs();
-            _boardDriver->setSquareLED(toRow, toCol, 255, 255, 255);
-            _boardDriver->showLEDs();
+            _boardDriver->clearLayerLED(LED_LAYER_HINTS, fromRow, fromCol);
         }
         
-        // Check if piece was placed on destination
-        if (piecePickedUp && _boardDriver->getSensorState(toRow, toCol)) {
-            moveCompleted = true;
+        if (status == RECOGNIZER_MOVE) {
+            _boardDriver->clearLayer(LED_LAYER_HINTS);
+            _boardDriver->clearLayer(LED_LAYER_ALERTS);
+            _boardDriver->showLEDs();
             Serial.println("Bot move completed on physical board!");
+            finishBotMove();
+            return;
         }
         
-        delay(50);
-        _boardDriver->updateSensorPrev();
+        // Put back on the source: blink it again
+        botPiecePickedUp = (recognizer.getOrigin() >= 0);
+        _boardDriver->clearLayer(LED_LAYER_ALERTS);
+        _boardDriver->fillLayer(LED_LAYER_ALERTS, recognizer.getMisplaced(), LED_ILLEGAL);
+        _boardDriver->showLEDs();
     }
 }
 
-void ChessBot::confirmMoveCompletion() {
-    // This will be called with specific square coordinates when we need them
-    confirmSquareCompletion(-1, -1); // Default - no specific square
-}
-
+// Green blink on the square a move landed on; the animator runs it
 void ChessBot::confirmSquareCompletion(int row, int col) {
-    if (row >= 0 && col >= 0) {
-        // Flash specific square twice
-        for (int flash = 0; flash < 2; flash++) {
-            _boardDriver->setSquareLED(row, col, 0, 255, 0); // Green flash
-            _boardDriver->showLEDs();
-            delay(150);
-            
-            _boardDriver->clearAllLEDs();
-            _boardDriver->showLEDs();
-            delay(150);
-        }
-    } else {
-        // Flash entire board (fallback for when we don't have specific coords)
-        for (int flash = 0; flash < 2; flash++) {
-            for (int r = 0; r < 8; r++) {
-                for (int c = 0; c < 8; c++) {
-                    _boardDriver->setSquareLED(r, c, 0, 255, 0); // Green flash
-                }
-            }
-            _boardDriver->showLEDs();
-            delay(150);
-            
-            _boardDriver->clearAllLEDs();
-            _boardDriver->showLEDs();
-            delay(150);
-        }
-    }
+    _boardDriver->blinkSquare(row, col, 2, LED_CONFIRM);
 }
 
 void ChessBot::printCurrentBoard() {
@@ -803,6 +1008,7 @@ void ChessBot::setDifficulty(BotDifficulty diff) {
         case BOT_HARD: settings = StockfishSettings::hard(); break;
         case BOT_EXPERT: settings = StockfishSettings::expert(); break;
     }
+    clearResponseCache(); // Cached replies were searched at the old depth
     
     Serial.print("Bot difficulty changed to: ");
     switch(difficulty) {
@@ -3,36 +3,73 @@
 
 #include "board_driver.h"
 #include "chess_engine.h"
+#include "engine_worker.h"
+#include "move_recognizer.h"
 #include "stockfish_settings.h"
 #include "arduino_secrets.h"
 #include <WiFiNINA.h>
 #include <WiFiSSLClient.h>
 
+// Stockfish replies remembered per position (direct-mapped on the Zobrist key)
+#define BOT_RESPONSE_CACHE_SIZE 16
+
+#define BOT_SETUP_CHECK_MS 100   // Start position check before a game
+#define BOT_MOVE_BLINK_MS  500   // Origin of the bot's move while it waits to be copied
+
 class ChessBot {
 private:
     BoardDriver* _boardDriver;
     ChessEngine* _chessEngine;
+    EngineWorker* _engineWorker;
     
     char board[8][8];
+    Position position;  // Game history; 'board' is refreshed from it after each move
+    MoveRecognizer recognizer;  // Physical board events to moves
     const char INITIAL_BOARD[8][8] = {
         {'R','N','B','Q','K','B','N','R'},  // row 0 (rank 1)
-        {'P','P','P','P','P','P','P','P'},  // row 1 (rank 2)
-        {' ',' ',' ',' ',' ',' ',' ',' '},  // row 2 (rank 3)
+        {' ',' ',' ',' ',' ',' ',' ',' '},  // row 1 (rank 2)
+        {'P','P','P','P','P','P','P','P'},  // row 2 (rank 3) White Bia
         {' ',' ',' ',' ',' ',' ',' ',' '},  // row 3 (rank 4)
         {' ',' ',' ',' ',' ',' ',' ',' '},  // row 4 (rank 5)
-        {' ',' ',' ',' ',' ',' ',' ',' '},  // row 5 (rank 6)
-        {'p','p','p','p','p','p','p','p'},  // row 6 (rank 7)
-        {'r','n','b','q','k','b','n','r'}   // row 7 (rank 8)
+        {'p','p','p','p','p','p','p','p'},  // row 5 (rank 6) Black Bia
+        {' ',' ',' ',' ',' ',' ',' ',' '},  // row 6 (rank 7)
+        {'r','n','b','k','q','b','n','r'}   // row 7 (rank 8)
     };
     
     StockfishSettings settings;
     BotDifficulty difficulty;
     
+    // Response cache: replaying a known position skips the FEN + HTTP round trip
+    struct CachedResponse {
+        ZobristKey key;
+        Move move;      // MOVE_NONE for an empty slot
+    };
+    CachedResponse responseCache[BOT_RESPONSE_CACHE_SIZE];
+    
+    // Offline opponent (also the fallback when Stockfish fails), running on
+    // the engine core. While the player thinks, the position after their
+    // expected reply is searched as a ponder job.
+    uint32_t searchJobId;           // Job whose reply the bot is waiting for (0 = none)
+    uint32_t ponderJobId;           // Running ponder job (0 = none)
+    ZobristKey ponderKey;           // Position the ponder job searches
+    
     bool isWhiteTurn;
     bool gameStarted;
+    bool setupPending;              // update() waits for the start position
+    unsigned long lastSetupCheck;
     bool botThinking;
+    bool botMovePending;            // Player moved: updateEngine() starts the bot's move
+    bool searchRetry;               // Engine queue was full: resubmit the search
     bool wifiConnected;
     
+    // Bot move shown on the board, waiting for the player to copy it
+    bool botMoveOnBoard;
+    Move botMove;
+    Move botExpectedReply;          // Ponder on this once the move is made
+    bool botPiecePickedUp;
+    bool botMoveBlinkOn;
+    unsigned long lastBotMoveBlink;
+    
     // FEN notation handling
     String boardToFEN();
     void fenToBoard(String fen);
@@ -41,31 +78,44 @@ private:
     bool connectToWiFi();
     String makeStockfishRequest(String fen);
     bool parseStockfishResponse(String response, String &bestMove);
+    bool requestStockfishMove(int &fromRow, int &fromCol, int &toRow, int &toCol);
+    bool startLocalSearch();
+    void handleEngineReply();
+    void startPondering(Move expected);
+    void stopPondering();
+    bool lookupCachedMove(ZobristKey key, int &fromRow, int &fromCol, int &toRow, int &toCol);
+    void storeCachedMove(ZobristKey key, int fromRow, int fromCol, int toRow, int toCol);
+    void clearResponseCache();
     
     // Move handling
     bool parseMove(String move, int &fromRow, int &fromCol, int &toRow, int &toCol);
-    void executeBotMove(int fromRow, int fromCol, int toRow, int toCol);
+    void executeBotMove(int fromRow, int fromCol, int toRow, int toCol, Move expectedReply = MOVE_NONE);
+    void finishBotMove();
     
     // URL encoding helper
     String urlEncode(String str);
     
     // Game flow
     void initializeBoard();
-    void waitForBoardSetup();
+    void startBoardSetup();
+    bool checkBoardSetup();
+    bool checkGameEnd();
+    void endGame();
     void processPlayerMove(int fromRow, int fromCol, int toRow, int toCol, char piece);
     void makeBotMove();
     void showBotThinking();
     void showConnectionStatus();
+    void showPickupLEDs();
     void showBotMoveIndicator(int fromRow, int fromCol, int toRow, int toCol);
-    void waitForBotMoveCompletion(int fromRow, int fromCol, int toRow, int toCol);
-    void confirmMoveCompletion();
+    void updateBotMoveOnBoard();
     void confirmSquareCompletion(int row, int col);
     void printCurrentBoard();
     
 public:
-    ChessBot(BoardDriver* boardDriver, ChessEngine* chessEngine, BotDifficulty diff = BOT_MEDIUM);
+    ChessBot(BoardDriver* boardDriver, ChessEngine* chessEngine, EngineWorker* engineWorker, BotDifficulty diff = BOT_MEDIUM);
     void begin();
-    void update();
+    void update();          // Player's moves
+    void updateEngine();    // Bot's moves (network, search, pondering)
     void setDifficulty(BotDifficulty diff);
 };
 
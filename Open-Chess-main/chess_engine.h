@@ -1,34 +1,35 @@
 #ifndef CHESS_ENGINE_H
 #define CHESS_ENGINE_H
 
+#include "position.h"
+
 // ---------------------------
 // Chess Engine Class
 // ---------------------------
 class ChessEngine {
 private:
-    // Helper functions for move generation
-    void addPawnMoves(const char board[8][8], int row, int col, char pieceColor, int &moveCount, int moves[][2]);
-    void addRookMoves(const char board[8][8], int row, int col, char pieceColor, int &moveCount, int moves[][2]);
-    void addKnightMoves(const char board[8][8], int row, int col, char pieceColor, int &moveCount, int moves[][2]);
-    void addBishopMoves(const char board[8][8], int row, int col, char pieceColor, int &moveCount, int moves[][2]);
-    void addQueenMoves(const char board[8][8], int row, int col, char pieceColor, int &moveCount, int moves[][2]);
-    void addKingMoves(const char board[8][8], int row, int col, char pieceColor, int &moveCount, int moves[][2]);
-    
-    bool isSquareOccupiedByOpponent(const char board[8][8], int row, int col, char pieceColor);
-    bool isSquareEmpty(const char board[8][8], int row, int col);
-    bool isValidSquare(int row, int col);
-    char getPieceColor(char piece);
+    // Position mirror of the last board passed in, rebuilt only when it changes
+    Position position;
+    char syncedBoard[8][8];
+    bool positionValid;
+
+    void syncPosition(const char board[8][8], int side);
+    int colorToSide(char color);
 
 public:
     ChessEngine();
     
     // Main move generation function
     void getPossibleMoves(const char board[8][8], int row, int col, int &moveCount, int moves[][2]);
+    Bitboard getMoveMask(const char board[8][8], int row, int col);
     
     // Move validation
     bool isValidMove(const char board[8][8], int fromRow, int fromCol, int toRow, int toCol);
     
-    // Game state checks
+    // Game state checks (color is 'w' or 'b')
+    bool isInCheck(const char board[8][8], char color);
+    bool isCheckmate(const char board[8][8], char color);
+    bool isStalemate(const char board[8][8], char color);
     bool isPawnPromotion(char piece, int targetRow);
     char getPromotedPiece(char piece);
     
@@ -3,6 +3,23 @@
 
 #include "board_driver.h"
 #include "chess_engine.h"
+#include "move_recognizer.h"
+
+// ---------------------------
+// Move Flow Configuration
+// ---------------------------
+#define MOVES_SETUP_CHECK_MS      500   // Setup display refresh while waiting for the start position
+#define MOVES_PROMOTION_BLINK_MS  250
+#define MOVES_EVENTS_PER_UPDATE   4     // Sensor events handled per update(), the rest wait
+
+// Where the human-vs-human flow stands; update() advances it without waiting
+enum MoveState : uint8_t {
+    MOVES_SETUP,                    // Waiting for the start position
+    MOVES_IDLE,                     // No piece in the air
+    MOVES_LIFTED,                   // A piece is in the air, its moves are shown
+    MOVES_CAPTURE_VICTIM_LIFTED,    // Capture under way: the victim is off, the attacker may still be down
+    MOVES_PROMOTING                 // A Bia promoted: waiting for it to be turned over on its square
+};
 
 // ---------------------------
 // Chess Game Mode Class
@@ -11,26 +28,46 @@ class ChessMoves {
 private:
     BoardDriver* boardDriver;
     ChessEngine* chessEngine;
-    
+
     // Expected initial configuration
     static const char INITIAL_BOARD[8][8];
-    
+
     // Internal board state for gameplay
     char board[8][8];
-    
+    bool gameOver;
+
+    // Move history of the current game (source of truth for 'board')
+    Position gamePosition;
+
+    // State machine, fed by the move recognizer
+    MoveState state;
+    MoveRecognizer recognizer;
+    int8_t promotionSquare;
+    bool promotionLifted;           // The promoted Bia is off its square
+    bool promotionBlinkOn;
+    unsigned long lastSetupCheck;
+    unsigned long lastPromotionBlink;
+
     // Helper functions
     void initializeBoard();
-    void waitForBoardSetup();
-    void processMove(int fromRow, int fromCol, int toRow, int toCol, char piece);
-    void checkForPromotion(int targetRow, int targetCol, char piece);
-    void handlePromotion(int targetRow, int targetCol, char piece);
+    void updateSetup(unsigned long now);
+    void updateIndicators(unsigned long now);
+    void handleEvent(const SensorEvent &event);
+    void completeMove(Move move);
+    void finishPromotion();
+    void showBoardLEDs();
+    void showLiftLEDs();
+    void processMove(Move move, char piece);
+    void checkGameState(char movedPiece);
 
 public:
     ChessMoves(BoardDriver* bd, ChessEngine* ce);
     void begin();
-    void update();
+    void update();                  // One step of the state machine, never waits
     bool isActive();
     void reset();
+    bool takeBackMove();
+    MoveState getState() const { return state; }
 };
 
-#endif // CHESS_MOVES_H
\ No newline at end of file
+#endif // CHESS_MOVES_H
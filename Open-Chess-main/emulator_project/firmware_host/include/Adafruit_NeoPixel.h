@@ -15,7 +15,9 @@ public:
     void setPixelColor(uint16_t n, uint8_t r, uint8_t g, uint8_t b, uint8_t w) {}
     void setPixelColor(uint16_t n, uint32_t c) {}
     void setBrightness(uint8_t t) {}
-    static uint32_t Color(uint8_t r, uint8_t g, uint8_t b, uint8_t w = 0) { return 0; }
+    static uint32_t Color(uint8_t r, uint8_t g, uint8_t b, uint8_t w = 0) {
+        return ((uint32_t)w << 24) | ((uint32_t)r << 16) | ((uint32_t)g << 8) | b;
+    }
     uint32_t getPixelColor(uint16_t n) const { return 0; }
     void clear() {}
 };
@@ -6,6 +6,8 @@
 #include <thread>
 #include <chrono>
 #include <vector>
+#include <cmath>
+#include <mutex>
 #include "WString.h"
 
 using byte = uint8_t;
@@ -44,6 +46,21 @@ inline unsigned long millis() {
     return duration_cast<milliseconds>(steady_clock::now() - start).count();
 }
 
+inline unsigned long micros() {
+    using namespace std::chrono;
+    static auto start = steady_clock::now();
+    return duration_cast<microseconds>(steady_clock::now() - start).count();
+}
+
+// Mock interrupts: one lock stands for "interrupts disabled". Host threads
+// that emulate interrupt handlers take it while they run.
+inline std::recursive_mutex &mockInterruptLock() {
+    static std::recursive_mutex lock;
+    return lock;
+}
+inline void noInterrupts() { mockInterruptLock().lock(); }
+inline void interrupts() { mockInterruptLock().unlock(); }
+
 inline void delay(unsigned long ms) {
     std::this_thread::sleep_for(std::chrono::milliseconds(ms));
 }
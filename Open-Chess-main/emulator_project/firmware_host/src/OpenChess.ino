@@ -3,6 +3,8 @@
 #include "chess_moves.h"
 #include "sensor_test.h"
 #include "chess_bot.h"
+#include "task_scheduler.h"
+#include "profiler.h"
 
 // Uncomment the next line to enable WiFi features (requires compatible board)
 //#define ENABLE_WIFI  // Currently disabled - RP2040 boards use local mode only
@@ -34,7 +36,8 @@ BoardDriver boardDriver;
 ChessEngine chessEngine;
 ChessMoves chessMoves(&boardDriver, &chessEngine);
 SensorTest sensorTest(&boardDriver);
-ChessBot chessBot(&boardDriver, &chessEngine, BOT_MEDIUM);
+EngineWorker engineWorker;
+ChessBot chessBot(&boardDriver, &chessEngine, &engineWorker, BOT_MEDIUM);
 
 #ifdef ENABLE_WIFI
 WiFiManager wifiManager;
@@ -51,6 +54,158 @@ void showGameSelection();
 void handleGameSelection();
 void initializeSelectedMode(GameMode mode);
 
+// ---------------------------
+// TASKS
+// ---------------------------
+// loop() only runs the scheduler. Tasks are listed by priority (sensors
+// first); a budget is what one run should normally take, anything longer is
+// logged as an overrun. The blocking waits that are left (game selection,
+// the Stockfish request, the player carrying out the bot's move) show up
+// there by task name.
+#define TASK_SENSORS_PERIOD_MS   0      // Every pass: loop-driven scans need the calls
+#define TASK_SENSORS_BUDGET_US   300
+#define TASK_LEDS_PERIOD_MS      10     // Animation frames and LED pushes, 100 Hz
+#define TASK_LEDS_BUDGET_US      3000   // A full NeoPixel push is about 2 ms
+#define TASK_MODE_PERIOD_MS      10
+#define TASK_MODE_BUDGET_US      1000
+#define TASK_BOT_PERIOD_MS       20
+#define TASK_BOT_BUDGET_US       (ENGINE_PONDER_SLICE_MS * 1000UL + 1000)
+#define TASK_WIFI_PERIOD_MS      50
+#define TASK_WIFI_BUDGET_US      2000
+#define TASK_STATUS_PERIOD_MS    10000
+#define TASK_STATUS_BUDGET_US    1000
+#define TASK_PROFILE_PERIOD_MS   1000   // Report itself every PROFILE_REPORT_MS
+#define TASK_PROFILE_BUDGET_US   20000  // Serial printing
+
+TaskScheduler scheduler;
+
+void taskSensors(uint32_t /* nowMs */) {
+  boardDriver.pollSensors();
+}
+
+void taskLeds(uint32_t nowMs) {
+  boardDriver.refreshLEDs(nowMs);
+}
+
+void taskMode(uint32_t /* nowMs */) {
+  if (currentMode == MODE_SELECTION) {
+    handleGameSelection();
+    return;
+  }
+
+  static bool modeChangeLogged = false;
+  if (!modeChangeLogged) {
+    Serial.print("DEBUG: Mode changed to: ");
+    Serial.println(currentMode);
+    modeChangeLogged = true;
+  }
+  // Initialize the selected mode if not already done
+  if (!modeInitialized) {
+    initializeSelectedMode(currentMode);
+    modeInitialized = true;
+  }
+  
+  // Run the current game mode
+  switch (currentMode) {
+    case MODE_CHESS_MOVES:
+      chessMoves.update();
+      break;
+    case MODE_CHESS_BOT:
+      chessBot.update();
+      break;
+    case MODE_SENSOR_TEST:
+      sensorTest.update();
+      break;
+    case MODE_GAME_3:
+      // Future game modes - placeholder
+      Serial.println("Game mode coming soon!");
+      delay(1000);
+      break;
+    default:
+      currentMode = MODE_SELECTION;
+      modeInitialized = false;
+      showGameSelection();
+      break;
+  }
+}
+
+void taskBot(uint32_t /* nowMs */) {
+  if (currentMode == MODE_CHESS_BOT && modeInitialized) {
+    chessBot.updateEngine();
+  }
+}
+
+#ifdef ENABLE_WIFI
+void taskWifi(uint32_t /* nowMs */) {
+  // Handle WiFi clients
+  {
+    PROFILE_SCOPE(PROFILE_HANDLE_CLIENT);
+    wifiManager.handleClient();
+  }
+  
+  // Check for WiFi game selection
+  int selectedMode = wifiManager.getSelectedGameMode();
+  if (selectedMode > 0) {
+    Serial.print("DEBUG: WiFi game selection detected: ");
+    Serial.println(selectedMode);
+    
+    switch (selectedMode) {
+      case 1:
+        currentMode = MODE_CHESS_MOVES;
+        break;
+      case 4:
+        currentMode = MODE_SENSOR_TEST;
+        break;
+      default:
+        Serial.println("Invalid game mode selected via WiFi");
+        selectedMode = 0;
+        break;
+    }
+    
+    if (selectedMode > 0) {
+      modeInitialized = false;
+      boardDriver.clearAllLEDs();
+      wifiManager.resetGameSelection();
+      
+      // Brief confirmation animation
+      for (int i = 0; i < 3; i++) {
+        boardDriver.setSquareLED(3, 3, LED_CONFIRM); // Green flash
+        boardDriver.setSquareLED(3, 4, LED_CONFIRM);
+        boardDriver.setSquareLED(4, 3, LED_CONFIRM);
+        boardDriver.setSquareLED(4, 4, LED_CONFIRM);
+        boardDriver.showLEDs();
+        delay(200);
+        boardDriver.clearAllLEDs();
+        boardDriver.showLEDs();
+        delay(200);
+      }
+    }
+  }
+  
+  // Check for a WiFi take back request
+  if (wifiManager.isTakeBackRequested()) {
+    wifiManager.resetTakeBack();
+    if (currentMode == MODE_CHESS_MOVES && modeInitialized) {
+      chessMoves.takeBackMove();
+    } else {
+      Serial.println("Take back is only available in Chess Moves mode");
+    }
+  }
+}
+#endif
+
+#if PROFILING_ENABLED
+void taskProfile(uint32_t nowMs) {
+  PROFILE_REPORT(nowMs);
+}
+#endif
+
+void taskStatus(uint32_t nowMs) {
+  Serial.print("DEBUG: Loop running, uptime: ");
+  Serial.print((unsigned long)(nowMs / 1000));
+  Serial.println(" seconds");
+}
+
 // ---------------------------
 // SETUP
 // ---------------------------
@@ -137,6 +292,18 @@ void setup() {
   Serial.println("Position 4 (4,4): Sensor Test");
   Serial.println();
   Serial.println("Place any chess piece on a white LED to select that mode");
+  scheduler.addTask("sensors", taskSensors, TASK_SENSORS_PERIOD_MS, TASK_SENSORS_BUDGET_US);
+  scheduler.addTask("leds", taskLeds, TASK_LEDS_PERIOD_MS, TASK_LEDS_BUDGET_US);
+  scheduler.addTask("mode", taskMode, TASK_MODE_PERIOD_MS, TASK_MODE_BUDGET_US);
+  scheduler.addTask("bot", taskBot, TASK_BOT_PERIOD_MS, TASK_BOT_BUDGET_US);
+#ifdef ENABLE_WIFI
+  scheduler.addTask("wifi", taskWifi, TASK_WIFI_PERIOD_MS, TASK_WIFI_BUDGET_US);
+#endif
+  scheduler.addTask("status", taskStatus, TASK_STATUS_PERIOD_MS, TASK_STATUS_BUDGET_US);
+#if PROFILING_ENABLED
+  scheduler.addTask("profile", taskProfile, TASK_PROFILE_PERIOD_MS, TASK_PROFILE_BUDGET_US);
+#endif
+
   Serial.println("================================================");
   Serial.println("         Setup Complete - Entering Main Loop");
   Serial.println("================================================");
@@ -146,7 +313,6 @@ void setup() {
 // MAIN LOOP
 // ---------------------------
 void loop() {
-  static unsigned long lastDebugPrint = 0;
   static bool firstLoop = true;
   
   if (firstLoop) {
@@ -154,98 +320,27 @@ void loop() {
     firstLoop = false;
   }
   
-  // Print periodic status every 10 seconds
-  if (millis() - lastDebugPrint > 10000) {
-    Serial.print("DEBUG: Loop running, uptime: ");
-    Serial.print(millis() / 1000);
-    Serial.println(" seconds");
-    lastDebugPrint = millis();
-  }
+  PROFILE_SCOPE(PROFILE_LOOP);
+  scheduler.run(millis());
+}
 
-#ifdef ENABLE_WIFI
-  // Handle WiFi clients
-  wifiManager.handleClient();
-  
-  // Check for WiFi game selection
-  int selectedMode = wifiManager.getSelectedGameMode();
-  if (selectedMode > 0) {
-    Serial.print("DEBUG: WiFi game selection detected: ");
-    Serial.println(selectedMode);
-    
-    switch (selectedMode) {
-      case 1:
-        currentMode = MODE_CHESS_MOVES;
-        break;
-      case 4:
-        currentMode = MODE_SENSOR_TEST;
-        break;
-      default:
-        Serial.println("Invalid game mode selected via WiFi");
-        selectedMode = 0;
-        break;
-    }
-    
-    if (selectedMode > 0) {
-      modeInitialized = false;
-      boardDriver.clearAllLEDs();
-      wifiManager.resetGameSelection();
-      
-      // Brief confirmation animation
-      for (int i = 0; i < 3; i++) {
-        boardDriver.setSquareLED(3, 3, 0, 255, 0, 0); // Green flash
-        boardDriver.setSquareLED(3, 4, 0, 255, 0, 0);
-        boardDriver.setSquareLED(4, 3, 0, 255, 0, 0);
-        boardDriver.setSquareLED(4, 4, 0, 255, 0, 0);
-        boardDriver.showLEDs();
-        delay(200);
-        boardDriver.clearAllLEDs();
-        delay(200);
-      }
-    }
-  }
-#endif
+// ---------------------------
+// ENGINE CORE
+// ---------------------------
+// Core 1 (RP2040) or the engine thread (FirmwareHost) only runs bot searches,
+// so sensor scanning and LEDs on core 0 never wait for the engine.
+#if ENGINE_WORKER_DUAL_CORE
+bool core1_separate_stack = true;  // Own 8 KB stack for the search recursion
 
-  if (currentMode == MODE_SELECTION) {
-    handleGameSelection();
-  } else {
-    static bool modeChangeLogged = false;
-    if (!modeChangeLogged) {
-      Serial.print("DEBUG: Mode changed to: ");
-      Serial.println(currentMode);
-      modeChangeLogged = true;
-    }
-    // Initialize the selected mode if not already done
-    if (!modeInitialized) {
-      initializeSelectedMode(currentMode);
-      modeInitialized = true;
-    }
-    
-    // Run the current game mode
-    switch (currentMode) {
-      case MODE_CHESS_MOVES:
-        chessMoves.update();
-        break;
-      case MODE_CHESS_BOT:
-        chessBot.update();
-        break;
-      case MODE_SENSOR_TEST:
-        sensorTest.update();
-        break;
-      case MODE_GAME_3:
-        // Future game modes - placeholder
-        Serial.println("Game mode coming soon!");
-        delay(1000);
-        break;
-      default:
-        currentMode = MODE_SELECTION;
-        modeInitialized = false;
-        showGameSelection();
-        break;
-    }
+void setup1() {
+}
+
+void loop1() {
+  if (!engineWorker.step(0)) {
+    delay(1); // Idle: no job queued
   }
-  
-  delay(50); // Small delay to prevent overwhelming the system
 }
+#endif
 
 // ---------------------------
 // GAME SELECTION FUNCTIONS
@@ -258,16 +353,16 @@ void showGameSelection() {
   // Light up the 4 selector positions in the middle of the board
   // All positions now use bright white for better visibility
   // Position 1: Chess Moves (row 3, col 3) - White
-  boardDriver.setSquareLED(3, 3, 0, 0, 0, 255);
+  boardDriver.setSquareLED(3, 3, LED_WHITE);
   
   // Position 2: Game Mode 2 (row 3, col 4) - White
-  boardDriver.setSquareLED(3, 4, 0, 0, 0, 255);
+  boardDriver.setSquareLED(3, 4, LED_WHITE);
   
   // Position 3: Game Mode 3 (row 4, col 3) - White
-  boardDriver.setSquareLED(4, 3, 0, 0, 0, 255);
+  boardDriver.setSquareLED(4, 3, LED_WHITE);
   
   // Position 4: Sensor Test (row 4, col 4) - White
-  boardDriver.setSquareLED(4, 4, 0, 0, 0, 255);
+  boardDriver.setSquareLED(4, 4, LED_WHITE);
   
   boardDriver.showLEDs();
 }
@@ -282,6 +377,7 @@ void handleGameSelection() {
     currentMode = MODE_CHESS_MOVES;
     modeInitialized = false;
     boardDriver.clearAllLEDs();
+    boardDriver.showLEDs();
     delay(500); // Debounce delay
   }
   else if (boardDriver.getSensorState(3, 4)) {
@@ -290,6 +386,7 @@ void handleGameSelection() {
     currentMode = MODE_CHESS_BOT;
     modeInitialized = false;
     boardDriver.clearAllLEDs();
+    boardDriver.showLEDs();
     delay(500);
   }
   else if (boardDriver.getSensorState(4, 3)) {
@@ -298,6 +395,7 @@ void handleGameSelection() {
     currentMode = MODE_GAME_3;
     modeInitialized = false;
     boardDriver.clearAllLEDs();
+    boardDriver.showLEDs();
     delay(500);
   }
   else if (boardDriver.getSensorState(4, 4)) {
@@ -306,10 +404,9 @@ void handleGameSelection() {
     currentMode = MODE_SENSOR_TEST;
     modeInitialized = false;
     boardDriver.clearAllLEDs();
+    boardDriver.showLEDs();
     delay(500);
   }
-  
-  delay(100);
 }
 
 void initializeSelectedMode(GameMode mode) {
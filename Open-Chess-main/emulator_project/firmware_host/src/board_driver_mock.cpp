@@ -1,4 +1,3 @@
-#include "board_driver.h"
 #include <iostream>
 #include <thread>
 #include <vector>
@@ -7,11 +6,14 @@
 #include <arpa/inet.h>
 #include <unistd.h>
 #include <mutex>
+#include <cmath>
 #include "Arduino.h"
+#include "board_driver.h"
+#include "sim_scan_transport.h"
 
-// Global shadow state
-static bool shadowSensors[8][8];
-static std::mutex sensorMutex;
+// Reed switches and row driver: the GUI moves pieces, the real SensorScanner
+// scans them through the simulated 74HC594
+static SimulatedScanTransport simTransport;
 
 // Socket globals
 static int sock = -1;
@@ -26,10 +28,11 @@ static void sendCmd(const std::string& cmd) {
     }
 }
 
-BoardDriver::BoardDriver() : strip(LED_COUNT, LED_PIN, NEO_GRBW + NEO_KHZ800) {
-    for (int r=0; r<8; r++)
-       for (int c=0; c<8; c++) 
-           shadowSensors[r][c] = false;
+BoardDriver::BoardDriver() : strip(LED_COUNT, LED_PIN, NEO_GRBW + NEO_KHZ800), scanner(&simTransport), animator(&leds) {
+    sensorBits = 0;
+    colorLut.setBrightness(BRIGHTNESS);
+    ledRepushAll = false;
+    ledPushCount = 0;
 }
 
 void BoardDriver::begin() {
@@ -58,8 +61,7 @@ void BoardDriver::begin() {
                             int r, c, s;
                             if (sscanf(line, "E %d %d %d", &r, &c, &s) == 3) {
                                 if (r >= 0 && r < 8 && c >= 0 && c < 8) {
-                                    std::lock_guard<std::mutex> lock(sensorMutex);
-                                    shadowSensors[r][c] = (s == 1);
+                                    simTransport.setSquare(r, c, s == 1);
                                     // Debug
                                     // std::cout << "Sensor " << r << "," << c << " = " << s << std::endl;
                                 }
@@ -76,96 +78,72 @@ void BoardDriver::begin() {
         });
         receiverThread.detach();
     }
-}
-
-void BoardDriver::readSensors() {
-    std::lock_guard<std::mutex> lock(sensorMutex);
-    for (int r=0; r<8; r++) {
-        for (int c=0; c<8; c++) {
-            sensorState[r][c] = shadowSensors[r][c];
-        }
-    }
-}
 
-bool BoardDriver::getSensorState(int row, int col) {
-    return sensorState[row][col];
-}
-
-bool BoardDriver::getSensorPrev(int row, int col) {
-    return sensorPrev[row][col];
+    scanner.begin();
+    waitForFrame();
+    readSensors();
 }
 
-void BoardDriver::updateSensorPrev() {
-    for (int row = 0; row < 8; row++) {
-        for (int col = 0; col < 8; col++) {
-            sensorPrev[row][col] = sensorState[row][col];
+// Strip PWM level (linear light) back to a level for the GUI's display, which
+// applies its own gamma: the GUI then shows what the board's LEDs would
+static int displayLevel(int linear) {
+    static uint8_t table[256];
+    static bool built = false;
+    if (!built) {
+        for (int i = 0; i < 256; i++) {
+            table[i] = (uint8_t)std::lround(255.0 * std::pow(i / 255.0, 1.0 / 2.5));
         }
+        built = true;
     }
+    return table[linear > 255 ? 255 : linear];
 }
 
-void BoardDriver::clearAllLEDs() {
-    sendCmd("C");
-}
-
-void BoardDriver::setSquareLED(int row, int col, uint32_t color) {
-    uint8_t r = (uint8_t)(color >> 16);
-    uint8_t g = (uint8_t)(color >> 8);
-    uint8_t b = (uint8_t)color;
-    // Assume no W for now? Or just ignore it? 
-    // Protocol L r c r g b
-    char cmd[64];
-    sprintf(cmd, "L %d %d %d %d %d", row, col, r, g, b);
-    sendCmd(cmd);
-}
-
-void BoardDriver::setSquareLED(int row, int col, uint8_t r, uint8_t g, uint8_t b, uint8_t w) {
-    // Protocol L r c r g b
-    // W is unsupported in simple protocol for now, can add later
-    char cmd[64];
-    sprintf(cmd, "L %d %d %d %d %d", row, col, r, g, b);
-    sendCmd(cmd);
-}
-
+// Same compositor and color LUT as the hardware driver; a push sends only
+// the changed squares to the GUI, so the TCP traffic mirrors what the strip would get
 void BoardDriver::showLEDs() {
+    Bitboard changed = leds.swap();
+    if (ledRepushAll) changed = ~(Bitboard)0;
+    ledRepushAll = false;
+    if (!changed) return;
+
+    PROFILE_SCOPE(PROFILE_SHOW_LEDS);   // Pushes only, skipped calls cost nothing
+
+    while (changed) {
+        int sq = popLsb(changed);
+        uint32_t color = colorLut.apply(leds.frontColor(sq));
+        // Protocol L r c r g b: no W channel, so white light is added to all three
+        int w = (int)(color >> 24);
+        int r = displayLevel((int)((color >> 16) & 0xFF) + w);
+        int g = displayLevel((int)((color >> 8) & 0xFF) + w);
+        int b = displayLevel((int)(color & 0xFF) + w);
+        char cmd[64];
+        sprintf(cmd, "L %d %d %d %d %d", squareRow(sq), squareCol(sq), r, g, b);
+        sendCmd(cmd);
+    }
     sendCmd("S");
+    ledPushCount = ledPushCount + 1;
 }
 
-// Animations - just delegate or simplify?
-// Original impl does loops with delays.
-// We can reproduce them or just send rapid commands. 
-// For now, let's keep the logic if we can, but it might be slow over TCP?
-// Actually, fireworkAnimation calls setSquareLED many times.
-// Mocking the behavior is safer.
-
-void BoardDriver::fireworkAnimation() {
-    // Just a placeholder for now
-    Serial.println("Firework Animation Triggered");
-}
-
-void BoardDriver::captureAnimation(int row, int col) {
-    Serial.println("Capture Animation Triggered");
-    blinkSquare(row, col, 2);
+void BoardDriver::highlightSquare(int row, int col, uint32_t color) {
+    setSquareLED(row, col, color);
+    showLEDs();
 }
 
-void BoardDriver::promotionAnimation(int col) {
-    Serial.println("Promotion Animation Triggered");
+// Animations come from the shared LedAnimator, so the GUI shows the real ones
+void BoardDriver::idle(unsigned long ms) {
+    unsigned long start = millis();
+    do {
+        tick(millis());
+        delay(1);
+    } while (millis() - start < ms);
 }
 
-void BoardDriver::blinkSquare(int row, int col, int times) {
-    for(int i=0; i<times; i++) {
-        setSquareLED(row, col, 255, 0, 0); // Red blink
-        showLEDs();
-        delay(200);
-        setSquareLED(row, col, 0, 0, 0);
-        showLEDs();
-        delay(200);
+void BoardDriver::waitForAnimations() {
+    while (isAnimating()) {
+        idle(1);
     }
 }
 
-void BoardDriver::highlightSquare(int row, int col, uint32_t color) {
-    setSquareLED(row, col, color);
-}
-
 // Helper methods from original (copied because private access needed if implemented differently, but here we just impl the interface)
 
 bool BoardDriver::checkInitialBoard(const char initialBoard[8][8]) {
@@ -175,7 +153,7 @@ bool BoardDriver::checkInitialBoard(const char initialBoard[8][8]) {
     for(int r=0; r<8; r++){
         for(int c=0; c<8; c++){
             bool hasPiece = (initialBoard[r][c] != ' ');
-            if (sensorState[r][c] != hasPiece) correct = false;
+            if (getSensorState(r, c) != hasPiece) correct = false;
         }
     }
     return correct;
@@ -188,10 +166,10 @@ void BoardDriver::updateSetupDisplay(const char initialBoard[8][8]) {
     for(int r=0; r<8; r++){
         for(int c=0; c<8; c++){
              bool hasPiece = (initialBoard[r][c] != ' ');
-             if (sensorState[r][c] != hasPiece) {
-                 setSquareLED(r, c, 255, 0, 0); // Red for error
+             if (getSensorState(r, c) != hasPiece) {
+                 setSquareLED(r, c, LED_ILLEGAL); // Red for error
              } else if (hasPiece) {
-                 setSquareLED(r, c, 0, 255, 0); // Green for OK
+                 setSquareLED(r, c, LED_CONFIRM); // Green for OK
              }
         }
     }
@@ -203,5 +181,4 @@ void BoardDriver::printBoardState(const char initialBoard[8][8]) {
 }
 
 // internal helpers unused here
-void BoardDriver::loadShiftRegister(byte data) {}
 int BoardDriver::getPixelIndex(int row, int col) { return 0; }
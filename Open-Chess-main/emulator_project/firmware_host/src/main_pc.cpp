@@ -1,4 +1,9 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
 #include "Arduino.h"
+#include "sensor_scanner.h"
+#include "sim_scan_transport.h"
 
 SerialMock Serial;
 
@@ -8,10 +13,105 @@ SerialMock Serial;
 // Include the sketch file directly
 #include "OpenChess.ino"
 
-int main() {
+// ---------------------------
+// Sensor Scan Benchmark
+// ---------------------------
+// Ticks the firmware's SensorScanner as fast as the host allows against the
+// simulated 74HC594 and checks every frame against the simulated board.
+// Returns non-zero if any frame was wrong (e.g. settleNs above the scan's
+// SENSOR_ROW_SETTLE_US).
+static int runScanBench(int frames, long settleNs) {
+    SimScanTiming timing = SimulatedScanTransport::defaultTiming();
+    if (settleNs >= 0) timing.settleNs = (uint32_t)settleNs;
+
+    // Makruk start position: rows 0, 2, 5 and 7 occupied
+    const Bitboard board = 0xFF00FF0000FF00FFULL;
+    SimulatedScanTransport transport(timing);
+    transport.setOccupancy(board);
+
+    SensorScanner scanner(&transport);
+    scanner.setScanPeriod(0);       // Back-to-back frames
+    scanner.begin(false);           // Ticked from here, no timer thread
+    transport.resetStats();
+
+    using namespace std::chrono;
+    unsigned long long ticks = 0;
+    long long maxTickNs = 0;
+    long long tickNs = 0;
+    int wrongFrames = 0;
+
+    auto start = steady_clock::now();
+    for (int f = 0; f < frames; f++) {
+        bool done = false;
+        while (!done) {
+            auto t0 = steady_clock::now();
+            done = scanner.tick(micros());
+            long long ns = duration_cast<nanoseconds>(steady_clock::now() - t0).count();
+            tickNs += ns;
+            if (ns > maxTickNs) maxTickNs = ns;
+            ticks++;
+        }
+        if (scanner.latestRawFrame() != board) wrongFrames++;
+    }
+    double elapsedMs = duration_cast<microseconds>(steady_clock::now() - start).count() / 1000.0;
+
+    SimScanStats stats = transport.stats();
+    printf("Scan bench: %d frames in %.1f ms (%.0f frames/s, %.0f us/frame)\n",
+           frames, elapsedMs, frames * 1000.0 / elapsedMs, elapsedMs * 1000.0 / frames);
+    printf("Ticks: %llu, %.0f ns avg, %lld ns max (host)\n", ticks, (double)tickNs / ticks, maxTickNs);
+    printf("Target GPIO time: %.1f us/frame (%lu row selects, %lu column reads)\n",
+           stats.gpioNs / 1000.0 / frames, stats.selects, stats.reads);
+    printf("Settle %u ns vs %d us scan: %lu stale reads, %d wrong frames\n",
+           timing.settleNs, SENSOR_ROW_SETTLE_US, stats.staleReads, wrongFrames);
+
+    // Debounce: a one-frame glitch must not produce an event, a held change
+    // exactly one, SENSOR_DEBOUNCE_SAMPLES frames later
+    auto scanFrame = [&scanner]() { while (!scanner.tick(micros())) {} };
+    SensorEvent event;
+    while (scanner.popEvent(event)) {}
+
+    transport.setSquare(2, 2, false);
+    scanFrame();
+    transport.setSquare(2, 2, true);
+    for (int i = 0; i < SENSOR_DEBOUNCE_SAMPLES; i++) scanFrame();
+    int glitchEvents = 0;
+    while (scanner.popEvent(event)) glitchEvents++;
+
+    transport.setSquare(2, 2, false);
+    int liftFrames = 0;
+    bool lifted = false;
+    while (!lifted && liftFrames < 2 * SENSOR_DEBOUNCE_MAX) {
+        scanFrame();
+        liftFrames++;
+        lifted = scanner.popEvent(event) && event.square == squareIndex(2, 2) && event.type == SENSOR_LIFT;
+    }
+    bool debounceOk = glitchEvents == 0 && lifted && liftFrames == SENSOR_DEBOUNCE_SAMPLES;
+    printf("Debounce: %d events from a 1-frame glitch, lift reported after %d frames (%s)\n",
+           glitchEvents, liftFrames, debounceOk ? "ok" : "FAILED");
+
+    return (wrongFrames == 0 && debounceOk) ? 0 : 1;
+}
+
+int main(int argc, char **argv) {
+    // FirmwareHost --scan-bench [frames] [settleNs]
+    if (argc > 1 && strcmp(argv[1], "--scan-bench") == 0) {
+        int frames = argc > 2 ? atoi(argv[2]) : 1000;
+        long settleNs = argc > 3 ? atol(argv[3]) : -1;
+        return runScanBench(frames, settleNs);
+    }
+
     // Run setup once
     setup();
     
+    // Engine core: same split as setup1()/loop1() on the RP2040
+    std::thread engineCore([] {
+        setup1();
+        while (1) {
+            loop1();
+        }
+    });
+    engineCore.detach();
+    
     // Run loop forever
     while (1) {
         loop();
@@ -0,0 +1,111 @@
+#include "sim_scan_transport.h"
+#include <chrono>
+
+SimScanTiming SimulatedScanTransport::defaultTiming() {
+    SimScanTiming t;
+    t.pinWriteNs = 250;       // arduino-pico digitalWrite() at 133 MHz
+    t.pinReadNs = 200;
+    t.propagationNs = 40;     // 74HC594 tPD at 4.5 V
+    t.settleNs = 20000;       // Reed switch and column pull-up RC
+    return t;
+}
+
+SimulatedScanTransport::SimulatedScanTransport(const SimScanTiming &t) : timing(t) {
+    occupancy = 0;
+    shiftStage = 0;
+    outputs = 0;
+    previousOutputs = 0;
+    outputsStableAtNs = 0;
+    resetStats();
+}
+
+unsigned long long SimulatedScanTransport::nowNs() {
+    using namespace std::chrono;
+    return duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+void SimulatedScanTransport::resetStats() {
+    counters.selects = 0;
+    counters.reads = 0;
+    counters.staleReads = 0;
+    counters.gpioNs = 0;
+}
+
+void SimulatedScanTransport::begin() {
+    // pinMode() for 3 outputs and 8 inputs, then release every row
+    counters.gpioNs += 11ULL * timing.pinWriteNs;
+    selectRow(-1);
+}
+
+// ---------------------------
+// 74HC594 Model
+// ---------------------------
+
+// SRCLK rising edge: SER enters QA, everything moves one stage towards QH
+void SimulatedScanTransport::shiftBit(bool bit) {
+    shiftStage = (uint8_t)((shiftStage << 1) | (bit ? 1 : 0));
+}
+
+// RCLK rising edge: the shift stage is copied to the outputs
+void SimulatedScanTransport::latch() {
+    previousOutputs = outputs;
+    outputs = shiftStage;
+}
+
+void SimulatedScanTransport::selectRow(int row) {
+    uint8_t data = row < 0 ? 0x00 : (uint8_t)(1 << row);
+
+    // Same sequence as GpioScanTransport::loadShiftRegister(): RCLK low,
+    // 8 x (SER, SRCLK high, SRCLK low), RCLK high, RCLK low
+    for (int i = 0; i < 8; i++) {
+        shiftBit((data & (1 << i)) != 0);
+    }
+    latch();
+
+    counters.selects++;
+    counters.gpioNs += (1 + 8 * 3 + 2) * (unsigned long long)timing.pinWriteNs;
+
+    // The latch edge comes one pin write before the end of the sequence
+    outputsStableAtNs = nowNs() - timing.pinWriteNs + timing.propagationNs + timing.settleNs;
+}
+
+// LSB-first loading leaves data bit 0 in QH, so QH..QA drive rows 0..7
+uint8_t SimulatedScanTransport::columnsFor(uint8_t rowOutputs) {
+    std::lock_guard<std::mutex> lock(occupancyMutex);
+    uint8_t bits = 0;
+    for (int q = 0; q < 8; q++) {
+        if (rowOutputs & (1 << q)) bits |= (uint8_t)(occupancy >> ((7 - q) * 8));
+    }
+    return bits;
+}
+
+uint8_t SimulatedScanTransport::readColumns() {
+    counters.reads++;
+    counters.gpioNs += 8ULL * timing.pinReadNs;
+
+    if (nowNs() < outputsStableAtNs) {
+        counters.staleReads++;
+        return columnsFor(previousOutputs);
+    }
+    return columnsFor(outputs);
+}
+
+// ---------------------------
+// Board Contents
+// ---------------------------
+
+void SimulatedScanTransport::setOccupancy(Bitboard bits) {
+    std::lock_guard<std::mutex> lock(occupancyMutex);
+    occupancy = bits;
+}
+
+void SimulatedScanTransport::setSquare(int row, int col, bool occupied) {
+    std::lock_guard<std::mutex> lock(occupancyMutex);
+    Bitboard bit = squareBit(squareIndex(row, col));
+    occupancy = occupied ? (occupancy | bit) : (occupancy & ~bit);
+}
+
+Bitboard SimulatedScanTransport::getOccupancy() {
+    std::lock_guard<std::mutex> lock(occupancyMutex);
+    return occupancy;
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <mutex>
+#include "scan_transport.h"
+#include "bitboard.h"
+
+// Timing of the simulated hardware, in nanoseconds
+struct SimScanTiming {
+    uint32_t pinWriteNs;     // One digitalWrite() on the target
+    uint32_t pinReadNs;      // One digitalRead() on the target
+    uint32_t propagationNs;  // 74HC594 RCLK rising edge to valid outputs
+    uint32_t settleNs;       // Row output change until the column inputs are stable
+};
+
+struct SimScanStats {
+    unsigned long selects;
+    unsigned long reads;
+    unsigned long staleReads;    // Columns sampled before the selected row had settled
+    unsigned long long gpioNs;   // Time the same pin traffic would take on the target
+};
+
+// Host stand-in for the row shift register and the column inputs.
+//
+// selectRow() replays the GpioScanTransport pin sequence against a model of
+// the 74HC594 (8-bit shift stage, storage latch, QH..QA driving rows 0..7)
+// and charges every pin access to gpioNs. readColumns() returns the row that
+// was driven before the last latch until propagation + settle time has
+// passed on the host clock, which is what an under-timed scan would see.
+class SimulatedScanTransport : public ScanTransport {
+public:
+    static SimScanTiming defaultTiming();
+
+    explicit SimulatedScanTransport(const SimScanTiming &timing = defaultTiming());
+
+    void begin() override;
+    void selectRow(int row) override;
+    uint8_t readColumns() override;
+
+    // Board contents as seen by the reed switches (set from the GUI thread)
+    void setOccupancy(Bitboard bits);
+    void setSquare(int row, int col, bool occupied);
+    Bitboard getOccupancy();
+
+    SimScanStats stats() const { return counters; }
+    void resetStats();
+
+private:
+    SimScanTiming timing;
+    SimScanStats counters;
+
+    std::mutex occupancyMutex;
+    Bitboard occupancy;
+
+    // 74HC594 model
+    uint8_t shiftStage;
+    uint8_t outputs;             // Storage register, drives the rows
+    uint8_t previousOutputs;     // What the rows showed before the last latch
+    unsigned long long outputsStableAtNs;
+
+    static unsigned long long nowNs();
+    void shiftBit(bool bit);
+    void latch();
+    uint8_t columnsFor(uint8_t rowOutputs);
+};
@@ -0,0 +1,297 @@
+// MakrukPerft - move generation correctness and speed harness for ChessEngine.
+//
+// Usage: MakrukPerft [depth] [--fen "<fen>"] [--position] [--quiet] [--check]
+//   depth       perft depth for every position (default 4)
+//   --fen       run a single FEN instead of the built-in suite
+//   --position  walk the tree with Position::makeMove/unmakeMove instead of
+//               copying char[8][8] boards through ChessEngine::getPossibleMoves
+//   --quiet     skip the per-root-move divide listing
+//   --check     compare the suite (both walkers) against the expected node
+//               counts, verify the incremental Zobrist keys against a full
+//               recomputation at every node and the pinned start-position key,
+//               and exit non-zero on mismatch (ctest regression gate)
+
+#include "Arduino.h"
+#include "chess_engine.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+SerialMock Serial;
+
+// ---------------------------
+// Test Positions
+// ---------------------------
+
+struct PerftPosition {
+    const char* name;
+    const char* fen;
+    int checkDepth;          // Depth verified by --check
+    uint64_t expectedNodes;  // Node count at checkDepth
+};
+
+// The first entry mirrors ChessMoves::INITIAL_BOARD in chess_moves.cpp.
+// FEN letters follow the firmware board (B = Khon, Q = Met); the Makruk
+// letters S and M are accepted as well.
+static const PerftPosition SUITE[] = {
+    {"initial board", "rnbkqbnr/8/pppppppp/8/8/PPPPPPPP/8/RNBQKBNR w", 4, 273026ULL},
+    {"standard makruk", "rnsmksnr/8/pppppppp/8/8/PPPPPPPP/8/RNSKMSNR w - - 0 1", 4, 273026ULL},
+    {"middlegame", "r1sk1s1r/4m3/p1pnpppp/1p1p4/4P3/PPPP1PPP/3M4/RNSK1SNR w", 3, 13394ULL},
+    {"white promotion", "8/2k5/8/3P4/8/4r3/2M5/3K2R1 w", 4, 87163ULL},
+    {"black promotion", "3k4/8/2m5/8/3p4/8/3R4/3K4 b", 4, 20000ULL},
+};
+
+static const int SUITE_SIZE = sizeof(SUITE) / sizeof(SUITE[0]);
+
+// Key of the initial board with White to move. Pinned so that any change to
+// the key tables (which would break hashes recorded on the device) is caught.
+static const ZobristKey INITIAL_BOARD_KEY = 0x4A4960438B1FAABCULL;
+
+// ---------------------------
+// Board Helpers
+// ---------------------------
+
+static ChessEngine engine;
+static bool verifyHash = false;
+static uint64_t hashErrors = 0;
+
+struct PerftMove {
+    int fromRow, fromCol, toRow, toCol;
+};
+
+static bool parseFen(const char* fen, char board[8][8], bool &whiteToMove) {
+    memset(board, ' ', 64);
+    int row = 7;
+    int col = 0;
+    const char* p = fen;
+
+    for (; *p && *p != ' '; p++) {
+        char c = *p;
+        if (c == '/') {
+            row--;
+            col = 0;
+        } else if (c >= '1' && c <= '8') {
+            col += c - '0';
+        } else if (c == '~') {
+            // Promoted-piece marker used by some Makruk FENs
+        } else {
+            if (row < 0 || col > 7) return false;
+            switch (c) {
+                case 'S': c = 'B'; break;
+                case 's': c = 'b'; break;
+                case 'M': c = 'Q'; break;
+                case 'm': c = 'q'; break;
+            }
+            if (pieceTypeFromChar(c) == PIECE_NONE) return false;
+            board[row][col++] = c;
+        }
+    }
+
+    while (*p == ' ') p++;
+    whiteToMove = (*p != 'b');
+    return row == 0;
+}
+
+static bool isOwnPiece(char piece, bool white) {
+    if (piece == ' ') return false;
+    return white ? (piece >= 'A' && piece <= 'Z') : (piece >= 'a' && piece <= 'z');
+}
+
+static int generateMoves(const char board[8][8], bool white, PerftMove list[]) {
+    int count = 0;
+    int moves[28][2];
+    for (int row = 0; row < 8; row++) {
+        for (int col = 0; col < 8; col++) {
+            if (!isOwnPiece(board[row][col], white)) continue;
+
+            int moveCount = 0;
+            engine.getPossibleMoves(board, row, col, moveCount, moves);
+            for (int i = 0; i < moveCount; i++) {
+                list[count++] = {row, col, moves[i][0], moves[i][1]};
+            }
+        }
+    }
+    return count;
+}
+
+static void applyMove(const char board[8][8], const PerftMove &m, char child[8][8]) {
+    memcpy(child, board, 64);
+    char piece = child[m.fromRow][m.fromCol];
+    if (engine.isPawnPromotion(piece, m.toRow)) {
+        piece = engine.getPromotedPiece(piece);
+    }
+    child[m.toRow][m.toCol] = piece;
+    child[m.fromRow][m.fromCol] = ' ';
+}
+
+// ---------------------------
+// Perft
+// ---------------------------
+
+static uint64_t perft(const char board[8][8], bool white, int depth) {
+    if (depth == 0) return 1;
+
+    PerftMove list[128];
+    int count = generateMoves(board, white, list);
+    if (depth == 1) return count;  // Bulk count at the leaves
+
+    uint64_t nodes = 0;
+    char child[8][8];
+    for (int i = 0; i < count; i++) {
+        applyMove(board, list[i], child);
+        nodes += perft(child, !white, depth - 1);
+    }
+    return nodes;
+}
+
+// Same tree walked in place with make/unmake
+static uint64_t perftPosition(Position &pos, int depth) {
+    if (depth == 0) return 1;
+
+    Move list[MAX_MOVES];
+    int count = pos.generateLegalMoves(list);
+    if (depth == 1) return count;
+
+    uint64_t nodes = 0;
+    for (int i = 0; i < count; i++) {
+        ZobristKey before = pos.getHashKey();
+        pos.makeMove(list[i]);
+        if (verifyHash && pos.getHashKey() != pos.computeHashKey()) hashErrors++;
+        nodes += perftPosition(pos, depth - 1);
+        pos.unmakeMove();
+        if (verifyHash && pos.getHashKey() != before) hashErrors++;
+    }
+    return nodes;
+}
+
+static uint64_t runPosition(const char* name, const char* fen, int depth, bool divide, bool usePosition) {
+    char board[8][8];
+    bool white = true;
+    if (!parseFen(fen, board, white)) {
+        printf("Invalid FEN: %s\n", fen);
+        return 0;
+    }
+
+    printf("=== %s%s ===\n%s\n", name, usePosition ? " (make/unmake)" : "", fen);
+
+    auto start = std::chrono::steady_clock::now();
+    uint64_t nodes = 0;
+
+    if (usePosition) {
+        static Position pos;
+        pos.setFromBoard(board, white ? SIDE_WHITE : SIDE_BLACK);
+        if (divide && depth > 1) {
+            Move list[MAX_MOVES];
+            int count = pos.generateLegalMoves(list);
+            for (int i = 0; i < count; i++) {
+                pos.makeMove(list[i]);
+                uint64_t sub = perftPosition(pos, depth - 1);
+                pos.unmakeMove();
+                printf("  %c%d%c%d: %llu\n",
+                       'a' + squareCol(moveFrom(list[i])), squareRow(moveFrom(list[i])) + 1,
+                       'a' + squareCol(moveTo(list[i])), squareRow(moveTo(list[i])) + 1,
+                       (unsigned long long)sub);
+                nodes += sub;
+            }
+        } else {
+            nodes = perftPosition(pos, depth);
+        }
+    } else if (divide && depth > 1) {
+        PerftMove list[128];
+        int count = generateMoves(board, white, list);
+        char child[8][8];
+        for (int i = 0; i < count; i++) {
+            applyMove(board, list[i], child);
+            uint64_t sub = perft(child, !white, depth - 1);
+            printf("  %c%d%c%d: %llu\n",
+                   'a' + list[i].fromCol, list[i].fromRow + 1,
+                   'a' + list[i].toCol, list[i].toRow + 1,
+                   (unsigned long long)sub);
+            nodes += sub;
+        }
+    } else {
+        nodes = perft(board, white, depth);
+    }
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    double nps = seconds > 0 ? nodes / seconds : 0;
+    printf("depth %d: %llu nodes in %.3f s (%.0f nodes/sec)\n\n",
+           depth, (unsigned long long)nodes, seconds, nps);
+    return nodes;
+}
+
+// ---------------------------
+// Main
+// ---------------------------
+
+int main(int argc, char* argv[]) {
+    int depth = 4;
+    const char* fen = nullptr;
+    bool divide = true;
+    bool check = false;
+    bool usePosition = false;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--fen") == 0 && i + 1 < argc) {
+            fen = argv[++i];
+        } else if (strcmp(argv[i], "--position") == 0) {
+            usePosition = true;
+        } else if (strcmp(argv[i], "--quiet") == 0) {
+            divide = false;
+        } else if (strcmp(argv[i], "--check") == 0) {
+            check = true;
+        } else if (argv[i][0] >= '0' && argv[i][0] <= '9') {
+            depth = atoi(argv[i]);
+        } else {
+            printf("Usage: %s [depth] [--fen \"<fen>\"] [--position] [--quiet] [--check]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    if (check) {
+        int failures = 0;
+        verifyHash = true;
+
+        char board[8][8];
+        bool white = true;
+        static Position start;
+        parseFen(SUITE[0].fen, board, white);
+        start.setFromBoard(board, SIDE_WHITE);
+        if (start.getHashKey() != INITIAL_BOARD_KEY) {
+            printf("FAIL: initial board key 0x%016llX, expected 0x%016llX\n\n",
+                   (unsigned long long)start.getHashKey(), (unsigned long long)INITIAL_BOARD_KEY);
+            failures++;
+        }
+
+        for (int walker = 0; walker < 2; walker++) {
+            for (int i = 0; i < SUITE_SIZE; i++) {
+                uint64_t nodes = runPosition(SUITE[i].name, SUITE[i].fen, SUITE[i].checkDepth, false, walker == 1);
+                if (nodes != SUITE[i].expectedNodes) {
+                    printf("FAIL: %s expected %llu nodes at depth %d, got %llu\n\n", SUITE[i].name,
+                           (unsigned long long)SUITE[i].expectedNodes, SUITE[i].checkDepth,
+                           (unsigned long long)nodes);
+                    failures++;
+                }
+            }
+        }
+        if (hashErrors) {
+            printf("FAIL: %llu incremental Zobrist keys differ from a full recomputation\n\n",
+                   (unsigned long long)hashErrors);
+            failures++;
+        }
+        printf("%s: %d failures in %d runs\n", failures ? "FAILED" : "PASSED", failures, 2 * SUITE_SIZE);
+        return failures ? 1 : 0;
+    }
+
+    if (fen) {
+        runPosition("custom", fen, depth, divide, usePosition);
+        return 0;
+    }
+
+    for (int i = 0; i < SUITE_SIZE; i++) {
+        runPosition(SUITE[i].name, SUITE[i].fen, depth, divide, usePosition);
+    }
+    return 0;
+}
@@ -0,0 +1,108 @@
+#include "engine_worker.h"
+#include <Arduino.h>
+
+// ---------------------------
+// Engine Worker Implementation
+// ---------------------------
+
+EngineWorker::EngineWorker() : cancelledId(0) {
+    nextId = 0;
+    busy = false;
+    spentMs = 0;
+    replyPending = false;
+    search.setAbortCheck(shouldAbort, this);
+}
+
+bool EngineWorker::shouldAbort(void *context) {
+    EngineWorker *worker = (EngineWorker *)context;
+    return worker->cancelledId.load(std::memory_order_relaxed) == worker->current.id;
+}
+
+// ---------------------------
+// Game Side
+// ---------------------------
+
+uint32_t EngineWorker::submit(uint8_t kind, const Position &root, const SearchLimits &limits) {
+    EngineJob job;
+    job.id = ++nextId;
+    if (job.id == 0) job.id = ++nextId;  // 0 means "no job"
+    job.kind = kind;
+    job.root = root;
+    job.limits = limits;
+    return jobs.push(job) ? job.id : 0;
+}
+
+void EngineWorker::cancel(uint32_t id) {
+    cancelledId.store(id, std::memory_order_relaxed);
+}
+
+bool EngineWorker::poll(EngineReply &reply) {
+    return replies.pop(reply);
+}
+
+// ---------------------------
+// Engine Side
+// ---------------------------
+
+bool EngineWorker::step(unsigned long ponderSliceMs) {
+    if (replyPending) {
+        // The job stays busy until the game side has room for its answer
+        if (!replies.push(pendingReply)) return false;
+        replyPending = false;
+        busy = false;
+        return true;
+    }
+
+    if (!busy) {
+        if (!jobs.pop(current)) return false;
+        if (cancelledId.load(std::memory_order_relaxed) == current.id) return true;  // Cancelled while queued
+
+        busy = true;
+        spentMs = 0;
+        best.bestMove = MOVE_NONE;
+        best.depth = 0;
+    }
+
+    // In single-core mode pondering must give the CPU back between slices;
+    // the table carries the work over from one slice to the next
+    bool sliced = (current.kind == ENGINE_JOB_PONDER && ponderSliceMs > 0);
+    SearchLimits limits = current.limits;
+    if (sliced) {
+        unsigned long remaining = current.limits.timeMs > spentMs ? current.limits.timeMs - spentMs : 1;
+        limits.timeMs = remaining < ponderSliceMs ? remaining : ponderSliceMs;
+    }
+
+    SearchResult result = search.search(current.root, limits, spentMs > 0);
+    spentMs += result.elapsedMs;
+    if (result.depth >= best.depth || best.bestMove == MOVE_NONE) best = result;
+
+    bool finished = !sliced ||
+                    result.stopReason != SEARCH_STOP_TIME ||
+                    spentMs >= current.limits.timeMs;
+    if (finished) {
+        best.stopReason = result.stopReason;
+        best.elapsedMs = spentMs;
+        finishJob(best);
+    }
+    return true;
+}
+
+void EngineWorker::finishJob(const SearchResult &result) {
+    EngineReply &reply = pendingReply;
+    reply.id = current.id;
+    reply.result = result;
+    reply.expectedReply = MOVE_NONE;
+
+    // The opponent's answer from the table: what to ponder on next
+    if (result.bestMove != MOVE_NONE) {
+        // Played and taken back on the job's own position: no copy on this core's stack
+        current.root.makeMove(result.bestMove);
+        Move expected = search.hashMove(current.root);
+        if (expected != MOVE_NONE && current.root.isLegal(expected)) reply.expectedReply = expected;
+        current.root.unmakeMove();
+    }
+    reply.hashStats = search.hashStats();
+
+    if (replies.push(reply)) busy = false;
+    else replyPending = true;
+}
@@ -0,0 +1,79 @@
+#ifndef ENGINE_WORKER_H
+#define ENGINE_WORKER_H
+
+#include "makruk_search.h"
+#include "spsc_queue.h"
+
+// ---------------------------
+// Execution Mode
+// ---------------------------
+// On the RP2040 (arduino-pico core) and in FirmwareHost the engine runs on
+// its own core/thread: loop1() or a std::thread keeps calling step(0).
+// Elsewhere ChessBot calls step() from its update(), one ponder slice at a time.
+#if defined(ARDUINO_ARCH_RP2040) || defined(FIRMWARE_HOST)
+#define ENGINE_WORKER_DUAL_CORE 1
+#else
+#define ENGINE_WORKER_DUAL_CORE 0
+#endif
+
+#define ENGINE_PONDER_SLICE_MS 10   // Single-core mode: ponder time per step()
+
+enum EngineJobKind : uint8_t {
+    ENGINE_JOB_SEARCH,              // Find the bot's move now
+    ENGINE_JOB_PONDER               // Search the position after the expected player move
+};
+
+struct EngineJob {
+    uint32_t id;
+    uint8_t kind;                   // EngineJobKind
+    Position root;
+    SearchLimits limits;
+};
+
+struct EngineReply {
+    uint32_t id;                    // Id of the job this answers
+    SearchResult result;
+    Move expectedReply;             // Opponent's best answer to result.bestMove, if known
+    TTStats hashStats;
+};
+
+// ---------------------------
+// Engine Worker Class
+// ---------------------------
+// Owns the search and talks to the game logic only through two lock-free
+// SPSC queues: jobs flow from core 0 to core 1, replies back. Jobs can be
+// cancelled by id, which stops a running search within SEARCH_CHECK_NODES.
+class EngineWorker {
+private:
+    MakrukSearch search;
+    SpscQueue<EngineJob, 2> jobs;
+    SpscQueue<EngineReply, 4> replies;
+
+    std::atomic<uint32_t> cancelledId;
+    uint32_t nextId;
+
+    // Job in progress (engine side)
+    EngineJob current;
+    bool busy;
+    SearchResult best;
+    unsigned long spentMs;
+    EngineReply pendingReply;       // Answer of the finished job
+    bool replyPending;              // Reply ring was full: step() pushes it again
+
+    static bool shouldAbort(void *context);
+    void finishJob(const SearchResult &result);
+
+public:
+    EngineWorker();
+
+    // Game side (core 0)
+    uint32_t submit(uint8_t kind, const Position &root, const SearchLimits &limits);  // 0 if the queue is full
+    void cancel(uint32_t id);
+    bool poll(EngineReply &reply);
+
+    // Engine side (core 1, or inline with a slice length in single-core mode).
+    // Returns false when there was nothing to do.
+    bool step(unsigned long ponderSliceMs);
+};
+
+#endif // ENGINE_WORKER_H
@@ -0,0 +1,218 @@
+#include "led_animator.h"
+
+#define FIREWORK_PHASE_FRAMES  12   // Radius 0 to 5.5 (or back) in 0.5 steps
+#define FIREWORK_FRAME_MS      100
+#define CAPTURE_FRAMES         3
+#define CAPTURE_FRAME_MS       100
+#define PROMOTION_FRAMES       16
+#define PROMOTION_FRAME_MS     100
+#define BLINK_FRAME_MS         200
+
+#define COLUMN_A_MASK  0x0101010101010101ULL
+
+// ---------------------------
+// Compile-time Table Generation
+// ---------------------------
+
+namespace {
+
+// Distances in half squares, squared: keeps the 3.5 board center integral
+constexpr int halfDistSq(int fromRow2, int fromCol2, int row, int col) {
+    return (2 * row - fromRow2) * (2 * row - fromRow2) + (2 * col - fromCol2) * (2 * col - fromCol2);
+}
+
+// |d - k/2| < 1/2  <=>  (k - 1)^2 < (2d)^2 < (k + 1)^2
+constexpr Bitboard ringMask(int fromRow2, int fromCol2, int k) {
+    Bitboard mask = 0;
+    for (int sq = 0; sq < 64; sq++) {
+        int d2 = halfDistSq(fromRow2, fromCol2, sq / 8, sq % 8);
+        if ((k == 0 || (k - 1) * (k - 1) < d2) && d2 < (k + 1) * (k + 1)) mask |= (Bitboard)1 << sq;
+    }
+    return mask;
+}
+
+// d <= k/2  <=>  (2d)^2 <= k^2
+constexpr Bitboard discMask(int fromRow2, int fromCol2, int k) {
+    Bitboard mask = 0;
+    for (int sq = 0; sq < 64; sq++) {
+        if (halfDistSq(fromRow2, fromCol2, sq / 8, sq % 8) <= k * k) mask |= (Bitboard)1 << sq;
+    }
+    return mask;
+}
+
+constexpr AnimationTables buildAnimationTables() {
+    AnimationTables t{};
+    for (int sq = 0; sq < 64; sq++) {
+        for (int k = 0; k < ANIM_RADIUS_STEPS; k++) {
+            t.disc[sq][k] = discMask(2 * (sq / 8), 2 * (sq % 8), k);
+        }
+    }
+    for (int k = 0; k < ANIM_RADIUS_STEPS; k++) {
+        t.boardRing[k] = ringMask(7, 7, k);
+    }
+    // Four lit squares wander up the column: row is lit when (frame + row) % 8 < 4
+    for (int frame = 0; frame < 8; frame++) {
+        for (int row = 0; row < 8; row++) {
+            if ((frame + row) % 8 < 4) t.promotionWave[frame] |= (Bitboard)1 << (row * 8);
+        }
+    }
+    return t;
+}
+
+} // namespace
+
+extern constexpr AnimationTables ANIMATION_TABLES = buildAnimationTables();
+
+// ---------------------------
+// LED Animator Implementation
+// ---------------------------
+
+LedAnimator::LedAnimator(LedCompositor *compositor) : leds(compositor) {
+    for (int i = 0; i < LED_ANIMATION_SLOTS; i++) {
+        slots[i].id = 0;
+        slots[i].type = ANIM_NONE;
+        slots[i].drawn = 0;
+    }
+    nextId = 1;
+}
+
+AnimationId LedAnimator::start(uint8_t type, int row, int col, uint16_t frames, uint16_t frameMs, uint32_t nowMs, uint32_t color) {
+    // Free slot, or make room by dropping the oldest animation
+    LedAnimation *slot = &slots[0];
+    for (int i = 0; i < LED_ANIMATION_SLOTS; i++) {
+        if (slots[i].type == ANIM_NONE) {
+            slot = &slots[i];
+            break;
+        }
+        if (nowMs - slots[i].startMs > nowMs - slot->startMs) slot = &slots[i];
+    }
+    if (slot->type != ANIM_NONE) stop(*slot);
+
+    slot->id = nextId;
+    nextId = (nextId == 0xFFFFFFFFUL) ? 1 : nextId + 1;
+    slot->type = type;
+    slot->row = (int8_t)row;
+    slot->col = (int8_t)col;
+    slot->frames = frames;
+    slot->frameMs = frameMs;
+    slot->startMs = nowMs;
+    slot->drawnFrame = -1;
+    slot->drawn = 0;
+    slot->color = color;
+    return slot->id;
+}
+
+AnimationId LedAnimator::startFirework(uint32_t nowMs) {
+    return start(ANIM_FIREWORK, 0, 0, 3 * FIREWORK_PHASE_FRAMES, FIREWORK_FRAME_MS, nowMs);
+}
+
+AnimationId LedAnimator::startCapture(int row, int col, uint32_t nowMs) {
+    return start(ANIM_CAPTURE, row, col, CAPTURE_FRAMES, CAPTURE_FRAME_MS, nowMs);
+}
+
+AnimationId LedAnimator::startPromotion(int col, uint32_t nowMs) {
+    return start(ANIM_PROMOTION, 0, col, PROMOTION_FRAMES, PROMOTION_FRAME_MS, nowMs);
+}
+
+AnimationId LedAnimator::startBlink(int row, int col, int times, uint32_t nowMs, uint32_t color) {
+    return start(ANIM_BLINK, row, col, (uint16_t)(times * 2), BLINK_FRAME_MS, nowMs, color);
+}
+
+void LedAnimator::stop(LedAnimation &anim) {
+    // Uncover the squares, then let the others repaint anything they shared
+    Bitboard squares = anim.drawn;
+    while (squares) {
+        leds->clear(LED_LAYER_EFFECTS, popLsb(squares));
+    }
+    anim.type = ANIM_NONE;
+    anim.id = 0;
+    anim.drawn = 0;
+    for (int i = 0; i < LED_ANIMATION_SLOTS; i++) {
+        slots[i].drawnFrame = -1;
+    }
+}
+
+void LedAnimator::cancel(AnimationId id) {
+    if (id == 0) return;
+    for (int i = 0; i < LED_ANIMATION_SLOTS; i++) {
+        if (slots[i].id == id) stop(slots[i]);
+    }
+}
+
+void LedAnimator::cancelAll() {
+    for (int i = 0; i < LED_ANIMATION_SLOTS; i++) {
+        if (slots[i].type != ANIM_NONE) stop(slots[i]);
+    }
+}
+
+bool LedAnimator::isRunning(AnimationId id) const {
+    if (id == 0) return false;
+    for (int i = 0; i < LED_ANIMATION_SLOTS; i++) {
+        if (slots[i].id == id) return true;
+    }
+    return false;
+}
+
+bool LedAnimator::isIdle() const {
+    for (int i = 0; i < LED_ANIMATION_SLOTS; i++) {
+        if (slots[i].type != ANIM_NONE) return false;
+    }
+    return true;
+}
+
+void LedAnimator::tick(uint32_t nowMs) {
+    for (int i = 0; i < LED_ANIMATION_SLOTS; i++) {
+        LedAnimation &anim = slots[i];
+        if (anim.type == ANIM_NONE) continue;
+
+        uint32_t frame = (nowMs - anim.startMs) / anim.frameMs;
+        if (frame >= anim.frames) {
+            stop(anim);
+            continue;
+        }
+        if ((int16_t)frame != anim.drawnFrame) {
+            drawFrame(anim, (int)frame);
+            anim.drawnFrame = (int16_t)frame;
+        }
+    }
+}
+
+void LedAnimator::drawFrame(LedAnimation &anim, int frame) {
+    const Bitboard ALL = ~(Bitboard)0;
+
+    switch (anim.type) {
+    case ANIM_FIREWORK: {
+        // Expand, contract, expand again; the rest of the board stays dark
+        int phase = frame / FIREWORK_PHASE_FRAMES;
+        int step = frame % FIREWORK_PHASE_FRAMES;
+        int k = (phase == 1) ? FIREWORK_PHASE_FRAMES - step : step;
+        leds->blit(LED_LAYER_EFFECTS, ALL, ANIMATION_TABLES.boardRing[k], LED_WHITE);
+        anim.drawn = ALL;
+        break;
+    }
+
+    case ANIM_CAPTURE: {
+        // Pulse grows from the capture point (radius 0.5, 1.5, 2.5), alternating red and orange-red
+        uint32_t color = (frame % 2 == 0) ? LED_RED : LED_ORANGE_RED;
+        int sq = squareIndex(anim.row, anim.col);
+        leds->blit(LED_LAYER_EFFECTS, ALL, ANIMATION_TABLES.disc[sq][2 * frame + 1], color);
+        anim.drawn = ALL;
+        break;
+    }
+
+    case ANIM_PROMOTION: {
+        // Golden wave moving up and down the column
+        Bitboard column = COLUMN_A_MASK << anim.col;
+        leds->blit(LED_LAYER_EFFECTS, column, ANIMATION_TABLES.promotionWave[frame % 8] << anim.col, LED_PROMOTION);
+        anim.drawn = column;
+        break;
+    }
+
+    case ANIM_BLINK: {
+        Bitboard bit = squareBit(squareIndex(anim.row, anim.col));
+        leds->blit(LED_LAYER_EFFECTS, bit, (frame % 2 == 0) ? bit : 0, anim.color);
+        anim.drawn = bit;
+        break;
+    }
+    }
+}
@@ -0,0 +1,82 @@
+#ifndef LED_ANIMATOR_H
+#define LED_ANIMATOR_H
+
+#include "led_compositor.h"
+
+// ---------------------------
+// Animation Configuration
+// ---------------------------
+#define LED_ANIMATION_SLOTS  4      // Animations that can run at the same time
+#define ANIM_RADIUS_STEPS    13     // Radii 0 .. 6 squares in half-square steps
+
+enum LedAnimationType : uint8_t {
+    ANIM_NONE,
+    ANIM_FIREWORK,              // Rings out from the center, back in, out again
+    ANIM_CAPTURE,               // Red pulses growing from the capture square
+    ANIM_PROMOTION,             // Golden wave up and down one column
+    ANIM_BLINK                  // One square on/off
+};
+
+typedef uint32_t AnimationId;   // 0 = no animation
+
+struct LedAnimation {
+    AnimationId id;
+    uint8_t type;               // LedAnimationType
+    int8_t row, col;
+    uint16_t frames;            // Length in frames
+    uint16_t frameMs;
+    uint32_t startMs;
+    int16_t drawnFrame;         // Last frame written to the layer, -1 = redraw
+    Bitboard drawn;             // Squares this animation covers on the effects layer
+    uint32_t color;             // Blink color
+};
+
+// ---------------------------
+// Animation Frame Tables
+// ---------------------------
+// Generated at compile time in led_animator.cpp with integer distances
+// (stored in flash on the RP2040), so a frame is a mask lookup instead of
+// a sqrt() per square. Radius index k means k/2 squares.
+struct AnimationTables {
+    Bitboard disc[64][ANIM_RADIUS_STEPS];       // dist <= k/2 around a square
+    Bitboard boardRing[ANIM_RADIUS_STEPS];      // Ring around the board center (3.5, 3.5)
+    Bitboard promotionWave[8];                  // Lit rows of column a, per frame % 8
+};
+
+extern const AnimationTables ANIMATION_TABLES;
+
+// ---------------------------
+// LED Animator Class
+// ---------------------------
+// Animations are small state objects in fixed slots, drawn on the effects
+// layer of the compositor. tick() picks the frame from the elapsed time and
+// only writes the layer when the frame changed, so it is cheap to call from
+// every loop iteration and a stalled loop skips frames instead of slowing
+// the animation down. A finished or cancelled animation uncovers its squares.
+class LedAnimator {
+private:
+    LedCompositor *leds;
+    LedAnimation slots[LED_ANIMATION_SLOTS];
+    AnimationId nextId;
+
+    AnimationId start(uint8_t type, int row, int col, uint16_t frames, uint16_t frameMs, uint32_t nowMs, uint32_t color = LED_WHITE);
+    void drawFrame(LedAnimation &anim, int frame);
+    void stop(LedAnimation &anim);
+
+public:
+    LedAnimator(LedCompositor *compositor);
+
+    AnimationId startFirework(uint32_t nowMs);
+    AnimationId startCapture(int row, int col, uint32_t nowMs);
+    AnimationId startPromotion(int col, uint32_t nowMs);
+    AnimationId startBlink(int row, int col, int times, uint32_t nowMs, uint32_t color = LED_WHITE);
+
+    void cancel(AnimationId id);
+    void cancelAll();
+    bool isRunning(AnimationId id) const;
+    bool isIdle() const;
+
+    void tick(uint32_t nowMs);  // Advance every running animation
+};
+
+#endif // LED_ANIMATOR_H
@@ -0,0 +1,82 @@
+#include "led_compositor.h"
+
+// ---------------------------
+// LED Compositor Implementation
+// ---------------------------
+
+LedCompositor::LedCompositor() {
+    for (int layer = 0; layer < LED_LAYER_COUNT; layer++) {
+        for (int sq = 0; sq < LED_SQUARES; sq++) {
+            layerColor[layer][sq] = 0;
+        }
+        layerMask[layer] = 0;
+    }
+    for (int sq = 0; sq < LED_SQUARES; sq++) {
+        backBuffer[sq] = 0;
+        frontBuffer[sq] = 0;
+    }
+    stale = 0;
+}
+
+void LedCompositor::set(uint8_t layer, int square, uint32_t color) {
+    Bitboard bit = squareBit(square);
+    if ((layerMask[layer] & bit) && layerColor[layer][square] == color) return;
+    layerColor[layer][square] = color;
+    layerMask[layer] |= bit;
+    stale |= bit;
+}
+
+void LedCompositor::clear(uint8_t layer, int square) {
+    Bitboard bit = squareBit(square);
+    stale |= layerMask[layer] & bit;
+    layerMask[layer] &= ~bit;
+}
+
+void LedCompositor::fill(uint8_t layer, Bitboard squares, uint32_t color) {
+    while (squares) {
+        set(layer, popLsb(squares), color);
+    }
+}
+
+void LedCompositor::blit(uint8_t layer, Bitboard cover, Bitboard lit, uint32_t color) {
+    while (cover) {
+        int sq = popLsb(cover);
+        set(layer, sq, (lit & squareBit(sq)) ? color : 0);
+    }
+}
+
+void LedCompositor::clearLayer(uint8_t layer) {
+    stale |= layerMask[layer];
+    layerMask[layer] = 0;
+}
+
+void LedCompositor::clearAll() {
+    for (int layer = 0; layer < LED_LAYER_COUNT; layer++) {
+        clearLayer(layer);
+    }
+}
+
+Bitboard LedCompositor::swap() {
+    // Front equals back after every swap, so only merged squares can differ
+    Bitboard changed = 0;
+    while (stale) {
+        int sq = popLsb(stale);
+        Bitboard bit = squareBit(sq);
+
+        // Merge: top-most covering layer wins, uncovered squares are off
+        uint32_t color = 0;
+        for (int layer = LED_LAYER_COUNT - 1; layer >= 0; layer--) {
+            if (layerMask[layer] & bit) {
+                color = layerColor[layer][sq];
+                break;
+            }
+        }
+        backBuffer[sq] = color;
+
+        if (backBuffer[sq] != frontBuffer[sq]) {
+            frontBuffer[sq] = backBuffer[sq];
+            changed |= bit;
+        }
+    }
+    return changed;
+}
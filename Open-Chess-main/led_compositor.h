@@ -0,0 +1,51 @@
+#ifndef LED_COMPOSITOR_H
+#define LED_COMPOSITOR_H
+
+#include "bitboard.h"
+#include "led_palette.h"
+
+#define LED_SQUARES 64
+
+// Draw order, bottom to top: a square shows the color of the highest layer that covers it
+enum LedLayer : uint8_t {
+    LED_LAYER_BASE,             // Pieces on the board, setup display
+    LED_LAYER_MOVES,            // Legal destinations of a lifted piece
+    LED_LAYER_HINTS,            // Selected square, bot move to copy, status indicators
+    LED_LAYER_ALERTS,           // Errors and confirmations
+    LED_LAYER_EFFECTS,          // Running animations (LedAnimator), drawn over everything
+    LED_LAYER_COUNT
+};
+
+// ---------------------------
+// LED Compositor Class
+// ---------------------------
+// Each game mode draws into its own layer; a layer only covers the squares
+// it set, everything else shows through from below. Changes mark squares
+// stale, and swap() re-merges only those into the back buffer, then copies
+// the squares that differ into the front buffer (what the strip shows).
+// Indexed by square (row * 8 + col), not by strip pixel.
+class LedCompositor {
+private:
+    uint32_t layerColor[LED_LAYER_COUNT][LED_SQUARES];
+    Bitboard layerMask[LED_LAYER_COUNT];        // Squares each layer covers
+    uint32_t backBuffer[LED_SQUARES];
+    uint32_t frontBuffer[LED_SQUARES];
+    Bitboard stale;                             // Squares to re-merge on the next swap
+
+public:
+    LedCompositor();
+
+    void set(uint8_t layer, int square, uint32_t color);
+    void clear(uint8_t layer, int square);      // Uncover: lower layers show through
+    void fill(uint8_t layer, Bitboard squares, uint32_t color);
+    void blit(uint8_t layer, Bitboard cover, Bitboard lit, uint32_t color);   // lit: color, rest of cover: off
+    void clearLayer(uint8_t layer);
+    void clearAll();
+
+    // Merge the stale squares, then swap: returns the squares whose front
+    // color changed, 0 when the strip already shows the composed frame
+    Bitboard swap();
+    uint32_t frontColor(int square) const { return frontBuffer[square]; }
+};
+
+#endif // LED_COMPOSITOR_H
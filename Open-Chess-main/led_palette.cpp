@@ -0,0 +1,52 @@
+#include "led_palette.h"
+
+// ---------------------------
+// Compile-time Table Generation
+// ---------------------------
+
+namespace {
+
+constexpr uint64_t isqrt(uint64_t n) {
+    uint64_t root = 0;
+    uint64_t bit = (uint64_t)1 << 62;
+    while (bit > n) bit >>= 2;
+    while (bit) {
+        if (n >= root + bit) {
+            n -= root + bit;
+            root = (root >> 1) + bit;
+        } else {
+            root >>= 1;
+        }
+        bit >>= 2;
+    }
+    return root;
+}
+
+// 255 * (i / 255)^2.5 = sqrt(i^5 / 255^3), in 8.8 fixed point then rounded
+constexpr GammaTable buildGammaTable() {
+    GammaTable t{};
+    for (uint64_t i = 0; i < 256; i++) {
+        uint64_t scaled = isqrt((i * i * i * i * i << 16) / (255ULL * 255ULL * 255ULL));
+        t.level[i] = (uint8_t)((scaled + 128) >> 8);
+    }
+    return t;
+}
+
+} // namespace
+
+extern constexpr GammaTable LED_GAMMA = buildGammaTable();
+
+// ---------------------------
+// LedColorLut Implementation
+// ---------------------------
+
+LedColorLut::LedColorLut() {
+    setBrightness(255);
+}
+
+void LedColorLut::setBrightness(uint8_t value) {
+    brightness = value;
+    for (int i = 0; i < 256; i++) {
+        lut[i] = (uint8_t)((LED_GAMMA.level[i] * value + 127) / 255);
+    }
+}
@@ -0,0 +1,68 @@
+#ifndef LED_PALETTE_H
+#define LED_PALETTE_H
+
+#include <stdint.h>
+
+// Packed WRGB, the same layout as Adafruit_NeoPixel::Color()
+constexpr uint32_t ledColor(uint8_t r, uint8_t g, uint8_t b, uint8_t w = 0) {
+    return ((uint32_t)w << 24) | ((uint32_t)r << 16) | ((uint32_t)g << 8) | b;
+}
+
+// ---------------------------
+// Named Palette
+// ---------------------------
+// Colors are perceptual (before gamma); LedColorLut turns them into PWM
+// levels. The dim entries are chosen so that at the default brightness the
+// LEDs get the same levels as the old uncorrected values (noted alongside).
+constexpr uint32_t LED_OFF          = 0;
+constexpr uint32_t LED_WHITE        = ledColor(0, 0, 0, 255);       // W channel only
+constexpr uint32_t LED_RGB_WHITE    = ledColor(255, 255, 255);
+constexpr uint32_t LED_RED          = ledColor(255, 0, 0);
+constexpr uint32_t LED_GREEN        = ledColor(0, 255, 0);
+constexpr uint32_t LED_BLUE         = ledColor(0, 0, 255);
+constexpr uint32_t LED_ORANGE_RED   = ledColor(255, 133, 0);        // Was (255, 50, 0)
+constexpr uint32_t LED_GOLD         = ledColor(255, 238, 0, 133);   // Was (255, 215, 0, 50)
+constexpr uint32_t LED_SOFT_WHITE   = ledColor(133, 133, 133);      // Was (50, 50, 50)
+
+// What the game modes show
+constexpr uint32_t LED_PIECE        = LED_SOFT_WHITE;   // Occupied square
+constexpr uint32_t LED_MOVE_TARGET  = LED_SOFT_WHITE;   // Legal empty destination
+constexpr uint32_t LED_CAPTURE_TARGET = LED_GREEN;      // Legal capture
+constexpr uint32_t LED_ILLEGAL      = LED_RED;          // Illegal square or piece
+constexpr uint32_t LED_CONFIRM      = LED_GREEN;        // Move done, mode selected
+constexpr uint32_t LED_SELECTED     = LED_RED;          // Lifted piece (bot mode)
+constexpr uint32_t LED_BOT_MOVE     = LED_RGB_WHITE;    // Bot move for the player to copy
+constexpr uint32_t LED_PROMOTION    = LED_GOLD;
+constexpr uint32_t LED_SENSOR       = LED_WHITE;        // Setup display, sensor test
+
+// ---------------------------
+// Gamma and Brightness
+// ---------------------------
+// Gamma 2.5 curve, generated at compile time in led_palette.cpp
+struct GammaTable {
+    uint8_t level[256];
+};
+
+extern const GammaTable LED_GAMMA;
+
+// 256-entry gamma x brightness table in RAM, rebuilt when the brightness
+// changes: correcting a color is one lookup per channel, with no per-pixel
+// multiply in the NeoPixel library.
+class LedColorLut {
+private:
+    uint8_t lut[256];
+    uint8_t brightness;
+
+public:
+    LedColorLut();
+    void setBrightness(uint8_t value);
+    uint8_t getBrightness() const { return brightness; }
+
+    uint8_t level(uint8_t value) const { return lut[value]; }
+    uint32_t apply(uint32_t color) const {
+        return ((uint32_t)lut[(color >> 24) & 0xFF] << 24) | ((uint32_t)lut[(color >> 16) & 0xFF] << 16) |
+               ((uint32_t)lut[(color >> 8) & 0xFF] << 8) | lut[color & 0xFF];
+    }
+};
+
+#endif // LED_PALETTE_H
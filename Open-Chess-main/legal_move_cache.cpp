@@ -0,0 +1,34 @@
+#include "legal_move_cache.h"
+#include "profiler.h"
+
+// ---------------------------
+// Legal Move Cache Implementation
+// ---------------------------
+
+LegalMoveCache::LegalMoveCache() {
+    for (int sq = 0; sq < 64; sq++) {
+        targets[sq] = 0;
+    }
+    key = 0;
+    valid = false;
+}
+
+void LegalMoveCache::build(Position &pos) {
+    PROFILE_SCOPE(PROFILE_LEGAL_MOVES);
+    for (int sq = 0; sq < 64; sq++) {
+        targets[sq] = 0;
+    }
+    Bitboard pieces = pos.bitboards().occupied;
+    while (pieces) {
+        int sq = popLsb(pieces);
+        targets[sq] = pos.legalMovesFrom(sq);
+    }
+    key = pos.getHashKey();
+    valid = true;
+}
+
+bool LegalMoveCache::refresh(Position &pos) {
+    if (valid && key == pos.getHashKey()) return false;
+    build(pos);
+    return true;
+}
@@ -0,0 +1,31 @@
+#ifndef LEGAL_MOVE_CACHE_H
+#define LEGAL_MOVE_CACHE_H
+
+#include "position.h"
+
+// ---------------------------
+// Legal Move Cache
+// ---------------------------
+// Legal destinations of every piece on the board (both sides), built once
+// per position: lifting a piece is then one table read instead of a move
+// generation. The position's Zobrist key tells whether the table is still
+// current, so a take-back to a position already cached costs nothing.
+class LegalMoveCache {
+private:
+    Bitboard targets[64];       // Empty squares have no targets
+    ZobristKey key;
+    bool valid;
+
+    void build(Position &pos);
+
+public:
+    LegalMoveCache();
+
+    // Rebuild if the position changed since the last call; true when rebuilt
+    bool refresh(Position &pos);
+    void invalidate() { valid = false; }
+
+    Bitboard targetsFrom(int sq) const { return targets[sq]; }
+};
+
+#endif // LEGAL_MOVE_CACHE_H
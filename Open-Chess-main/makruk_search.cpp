@@ -0,0 +1,343 @@
+#include "makruk_search.h"
+#include <Arduino.h>
+
+// ---------------------------
+// Evaluation Tables
+// ---------------------------
+
+// Centipawn values indexed by PieceType (the Khun is never captured)
+static const int PIECE_VALUE[PIECE_TYPE_COUNT] = {100, 500, 300, 250, 200, 0};
+
+// Bonus for the short-range pieces standing near the centre
+static const int8_t CENTER_BONUS[64] = {
+    0, 2,  4,  6,  6,  4, 2, 0,
+    2, 6,  8, 10, 10,  8, 6, 2,
+    4, 8, 12, 14, 14, 12, 8, 4,
+    6, 10, 14, 18, 18, 14, 10, 6,
+    6, 10, 14, 18, 18, 14, 10, 6,
+    4, 8, 12, 14, 14, 12, 8, 4,
+    2, 6,  8, 10, 10,  8, 6, 2,
+    0, 2,  4,  6,  6,  4, 2, 0
+};
+
+// Bia bonus by row as seen from its own side (starts on row 2, promotes on row 5)
+static const int BIA_ROW_BONUS[8] = {0, 0, 0, 10, 25, 45, 45, 45};
+
+// ---------------------------
+// Makruk Search Implementation
+// ---------------------------
+
+// Mate scores are stored relative to the node, not the root
+static int scoreToTT(int score, int ply) {
+    if (score > SEARCH_MATE - SEARCH_MAX_PLY) return score + ply;
+    if (score < -SEARCH_MATE + SEARCH_MAX_PLY) return score - ply;
+    return score;
+}
+
+static int scoreFromTT(int score, int ply) {
+    if (score > SEARCH_MATE - SEARCH_MAX_PLY) return score - ply;
+    if (score < -SEARCH_MATE + SEARCH_MAX_PLY) return score + ply;
+    return score;
+}
+
+MakrukSearch::MakrukSearch() {
+    startTime = 0;
+    timeBudget = 0;
+    nodes = 0;
+    stopped = false;
+    aborted = false;
+    rootBestMove = MOVE_NONE;
+    abortCheck = nullptr;
+    abortContext = nullptr;
+}
+
+void MakrukSearch::setAbortCheck(SearchAbortCheck check, void *context) {
+    abortCheck = check;
+    abortContext = context;
+}
+
+SearchResult MakrukSearch::search(const Position &root, const SearchLimits &limits, bool resume) {
+    pos = root;
+    startTime = millis();
+    timeBudget = limits.timeMs;
+    nodes = 0;
+    stopped = false;
+    aborted = false;
+
+    if (!resume) {
+        tt.newSearch();
+        tt.resetStats();
+        for (int ply = 0; ply < SEARCH_MAX_PLY; ply++) {
+            killers[ply][0] = killers[ply][1] = MOVE_NONE;
+        }
+    }
+
+    SearchResult result;
+    result.bestMove = MOVE_NONE;
+    result.score = 0;
+    result.depth = 0;
+    result.stopReason = SEARCH_STOP_DEPTH;
+
+    // Always have a move ready, even if the first iteration runs out of time
+    Move list[MAX_MOVES];
+    int count = pos.generateLegalMoves(list);
+    if (count > 0) result.bestMove = list[0];
+    if (count <= 1) result.stopReason = SEARCH_STOP_ONLY_MOVE;
+
+    unsigned long softLimit = limits.timeMs * SEARCH_SOFT_TIME_PERCENT / 100;
+    int maxDepth = limits.maxDepth < SEARCH_MAX_PLY ? limits.maxDepth : SEARCH_MAX_PLY - 1;
+    int stableIterations = 0;
+
+    for (int depth = 1; depth <= maxDepth && count > 1; depth++) {
+        rootBestMove = MOVE_NONE;
+        int score = alphaBeta(depth, -SEARCH_INFINITY, SEARCH_INFINITY, 0);
+
+        if (stopped) {
+            // The previous best move is searched first, so a move that
+            // already replaced it in this iteration is at least as good
+            if (rootBestMove != MOVE_NONE) result.bestMove = rootBestMove;
+            result.stopReason = aborted ? SEARCH_STOP_ABORTED : SEARCH_STOP_TIME;
+            break;
+        }
+
+        stableIterations = (rootBestMove == result.bestMove) ? stableIterations + 1 : 0;
+        result.depth = depth;
+        result.score = score;
+        if (rootBestMove != MOVE_NONE) result.bestMove = rootBestMove;
+
+        // A forced mate will not get any better
+        if (score >= SEARCH_MATE - SEARCH_MAX_PLY || score <= -SEARCH_MATE + SEARCH_MAX_PLY) {
+            result.stopReason = SEARCH_STOP_MATE;
+            break;
+        }
+
+        // The next iteration would most likely not finish in time
+        if (depth < maxDepth && millis() - startTime >= softLimit) {
+            result.stopReason = SEARCH_STOP_TIME;
+            break;
+        }
+
+        if (depth >= SEARCH_EASY_MIN_DEPTH && depth < maxDepth && stableIterations >= SEARCH_EASY_STABLE &&
+            isEasyMove(result.bestMove, score, depth)) {
+            result.stopReason = SEARCH_STOP_EASY_MOVE;
+            break;
+        }
+    }
+
+    result.nodes = nodes;
+    result.elapsedMs = millis() - startTime;
+    return result;
+}
+
+Move MakrukSearch::hashMove(const Position &p) {
+    const TTEntry *entry = tt.probe(p.getHashKey());
+    return entry ? entry->move : MOVE_NONE;
+}
+
+// Reduced-depth check that every other root move is clearly worse
+bool MakrukSearch::isEasyMove(Move best, int score, int depth) {
+    int threshold = score - SEARCH_EASY_MARGIN;
+
+    Move *list = moveLists[0];
+    int count = pos.generateLegalMoves(list);
+    for (int i = 0; i < count; i++) {
+        if (list[i] == best) continue;
+
+        pos.makeMove(list[i]);
+        int value = -alphaBeta(depth / 2, -threshold, -threshold + 1, 1);
+        pos.unmakeMove();
+        if (stopped || value >= threshold) return false;
+    }
+    return true;
+}
+
+bool MakrukSearch::checkTime() {
+    if ((nodes & (SEARCH_CHECK_NODES - 1)) == 0) {
+        if (millis() - startTime >= timeBudget) {
+            stopped = true;
+        } else if (abortCheck && abortCheck(abortContext)) {
+            stopped = true;
+            aborted = true;
+        }
+    }
+    return stopped;
+}
+
+// ---------------------------
+// Evaluation
+// ---------------------------
+
+// Material plus piece placement, from the side to move's point of view
+int MakrukSearch::evaluate() {
+    const BoardBitboards &bb = pos.bitboards();
+    int score = 0;
+
+    for (int side = 0; side < 2; side++) {
+        int sideScore = 0;
+        for (int type = 0; type < PIECE_TYPE_COUNT; type++) {
+            Bitboard pieces = bb.pieces[side][type];
+            sideScore += bitCount(pieces) * PIECE_VALUE[type];
+
+            while (pieces) {
+                int sq = popLsb(pieces);
+                if (type == PIECE_BIA) {
+                    sideScore += BIA_ROW_BONUS[(side == SIDE_WHITE) ? squareRow(sq) : 7 - squareRow(sq)];
+                } else if (type != PIECE_RUA && type != PIECE_KHUN) {
+                    sideScore += CENTER_BONUS[sq];
+                }
+            }
+        }
+        score += (side == SIDE_WHITE) ? sideScore : -sideScore;
+    }
+
+    return (pos.getSideToMove() == SIDE_WHITE) ? score : -score;
+}
+
+// ---------------------------
+// Alpha-Beta
+// ---------------------------
+
+int MakrukSearch::alphaBeta(int depth, int alpha, int beta, int ply) {
+    if (ply > 0 && pos.repetitionCount() > 0) return 0;
+
+    int side = pos.getSideToMove();
+    bool inCheck = pos.isInCheck(side);
+    if (inCheck && ply < SEARCH_MAX_PLY / 2) depth++;  // Check extension
+
+    if (depth <= 0) return quiesce(alpha, beta, ply);
+    if (ply >= SEARCH_MAX_PLY - 1) return evaluate();
+
+    nodes++;
+    if (checkTime()) return 0;
+
+    ZobristKey key = pos.getHashKey();
+    Move ttMove = MOVE_NONE;
+    const TTEntry *entry = tt.probe(key);
+    if (entry) {
+        ttMove = entry->move;
+        if (ply > 0 && entry->depth >= depth) {
+            int ttScore = scoreFromTT(entry->score, ply);
+            if (entry->bound() == TT_BOUND_EXACT) return ttScore;
+            if (entry->bound() == TT_BOUND_LOWER && ttScore >= beta) return ttScore;
+            if (entry->bound() == TT_BOUND_UPPER && ttScore <= alpha) return ttScore;
+        }
+    }
+
+    Move *list = moveLists[ply];
+    int count = pos.generateLegalMoves(list);
+    if (count == 0) {
+        // Checkmate, or stalemate (a draw in Makruk)
+        return inCheck ? -SEARCH_MATE + ply : 0;
+    }
+    orderMoves(list, count, ttMove, ply);
+
+    int originalAlpha = alpha;
+    int bestScore = -SEARCH_INFINITY;
+    Move bestMove = list[0];
+
+    for (int i = 0; i < count; i++) {
+        Move m = list[i];
+        bool quiet = pos.pieceOn(moveTo(m)) == NO_PIECE;
+
+        pos.makeMove(m);
+        int score = -alphaBeta(depth - 1, -beta, -alpha, ply + 1);
+        pos.unmakeMove();
+        if (stopped) return 0;
+
+        if (score > bestScore) {
+            bestScore = score;
+            bestMove = m;
+            if (ply == 0) rootBestMove = m;
+        }
+        if (score > alpha) alpha = score;
+        if (alpha >= beta) {
+            if (quiet && killers[ply][0] != m) {
+                killers[ply][1] = killers[ply][0];
+                killers[ply][0] = m;
+            }
+            break;
+        }
+    }
+
+    uint8_t bound = (bestScore <= originalAlpha) ? TT_BOUND_UPPER
+                  : (bestScore >= beta) ? TT_BOUND_LOWER
+                  : TT_BOUND_EXACT;
+    tt.store(key, (bound == TT_BOUND_UPPER) ? MOVE_NONE : bestMove, scoreToTT(bestScore, ply), depth, bound);
+    return bestScore;
+}
+
+// Resolve captures so the static evaluation is not taken mid-exchange
+int MakrukSearch::quiesce(int alpha, int beta, int ply) {
+    nodes++;
+    if (checkTime()) return 0;
+
+    int standPat = evaluate();
+    if (standPat >= beta || ply >= SEARCH_MAX_PLY - 1) return standPat;
+    if (standPat > alpha) alpha = standPat;
+
+    int side = pos.getSideToMove();
+    Bitboard enemies = pos.bitboards().bySide[side ^ 1];
+
+    Move *list = moveLists[ply];
+    int count = 0;
+    Bitboard pieces = pos.bitboards().bySide[side];
+    while (pieces) {
+        int from = popLsb(pieces);
+        Bitboard targets = pos.legalMovesFrom(from) & enemies;
+        while (targets) {
+            list[count++] = pos.createMove(from, popLsb(targets));
+        }
+    }
+    orderMoves(list, count, MOVE_NONE, ply);
+
+    for (int i = 0; i < count; i++) {
+        pos.makeMove(list[i]);
+        int score = -quiesce(-beta, -alpha, ply + 1);
+        pos.unmakeMove();
+        if (stopped) return 0;
+
+        if (score >= beta) return score;
+        if (score > alpha) alpha = score;
+    }
+    return alpha;
+}
+
+// ---------------------------
+// Move Ordering
+// ---------------------------
+
+// TT move first, then captures by MVV-LVA, promotions, killers, quiet moves
+int MakrukSearch::scoreMove(Move m, Move ttMove, int ply) {
+    if (m == ttMove) return 1 << 20;
+
+    uint8_t victim = pos.pieceOn(moveTo(m));
+    if (victim != NO_PIECE) {
+        int attacker = pieceCodeType(pos.pieceOn(moveFrom(m)));
+        return (1 << 16) + PIECE_VALUE[pieceCodeType(victim)] * 8 - PIECE_VALUE[attacker] / 8;
+    }
+    if (isPromotionMove(m)) return 1 << 15;
+    if (m == killers[ply][0]) return 1 << 14;
+    if (m == killers[ply][1]) return (1 << 14) - 1;
+    return 0;
+}
+
+void MakrukSearch::orderMoves(Move list[], int count, Move ttMove, int ply) {
+    int *scores = moveScores;
+    for (int i = 0; i < count; i++) {
+        scores[i] = scoreMove(list[i], ttMove, ply);
+    }
+
+    // Insertion sort, highest score first (lists are short)
+    for (int i = 1; i < count; i++) {
+        Move m = list[i];
+        int s = scores[i];
+        int j = i - 1;
+        while (j >= 0 && scores[j] < s) {
+            list[j + 1] = list[j];
+            scores[j + 1] = scores[j];
+            j--;
+        }
+        list[j + 1] = m;
+        scores[j + 1] = s;
+    }
+}
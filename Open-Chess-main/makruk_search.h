@@ -0,0 +1,114 @@
+#ifndef MAKRUK_SEARCH_H
+#define MAKRUK_SEARCH_H
+
+#include "position.h"
+#include "transposition_table.h"
+#include "stockfish_settings.h"
+
+// ---------------------------
+// Search Constants
+// ---------------------------
+#define SEARCH_MAX_PLY     32      // Bounds recursion depth
+#define SEARCH_INFINITY    30000
+#define SEARCH_MATE        29000   // Mate in N plies scores SEARCH_MATE - N
+#define SEARCH_CHECK_NODES 256     // Clock is read every this many nodes
+
+// Time management
+#define SEARCH_SOFT_TIME_PERCENT 45  // No new iteration once this share of the budget is used
+#define SEARCH_EASY_MIN_DEPTH    5   // Shallowest iteration trusted for an easy move
+#define SEARCH_EASY_MARGIN       150 // Every other move must be this much worse
+#define SEARCH_EASY_STABLE       3   // ... and the best move unchanged for this many iterations
+
+struct SearchLimits {
+    int maxDepth;               // Iterative deepening stops after this depth
+    unsigned long timeMs;       // Hard budget for the whole search
+};
+
+// The same difficulty presets that drive the Stockfish request
+inline SearchLimits searchLimitsFor(const StockfishSettings &settings) {
+    SearchLimits limits;
+    limits.maxDepth = settings.depth;
+    limits.timeMs = (unsigned long)settings.timeoutMs;
+    return limits;
+}
+
+enum SearchStop : uint8_t {
+    SEARCH_STOP_DEPTH,          // Reached maxDepth
+    SEARCH_STOP_TIME,           // Soft or hard time limit
+    SEARCH_STOP_EASY_MOVE,      // One move is clearly best
+    SEARCH_STOP_MATE,           // Forced mate found
+    SEARCH_STOP_ONLY_MOVE,      // Zero or one legal move, nothing to search
+    SEARCH_STOP_ABORTED         // Abort check fired (search no longer wanted)
+};
+
+// Polled together with the clock; returning true stops the search
+typedef bool (*SearchAbortCheck)(void *context);
+
+struct SearchResult {
+    Move bestMove;              // MOVE_NONE if the side to move has no legal move
+    int score;                  // Centipawns from the side to move's point of view
+    int depth;                  // Last fully completed iteration
+    uint8_t stopReason;         // SearchStop
+    unsigned long nodes;
+    unsigned long elapsedMs;
+};
+
+// ---------------------------
+// Makruk Search Class
+// ---------------------------
+// Iterative-deepening alpha-beta with a transposition table, quiescence on
+// captures and TT/MVV-LVA/killer move ordering. Searches its own Position
+// copy with make/unmake, so nothing is allocated while thinking.
+//
+// Time control: the hard budget aborts the running iteration (its best move
+// is kept if it already beat the previous one), no iteration starts past the
+// soft limit, and a move that stays best and beats every alternative by a
+// wide margin ends the search early.
+class MakrukSearch {
+private:
+    Position pos;
+    TranspositionTable tt;
+    Move killers[SEARCH_MAX_PLY][2];
+
+    // Move lists live here rather than on the stack, which stays small
+    // enough for the RP2040's second core
+    Move moveLists[SEARCH_MAX_PLY][MAX_MOVES];
+    int moveScores[MAX_MOVES];
+
+    unsigned long startTime;
+    unsigned long timeBudget;
+    unsigned long nodes;
+    bool stopped;
+    bool aborted;
+    Move rootBestMove;
+
+    SearchAbortCheck abortCheck;
+    void *abortContext;
+
+    int evaluate();
+    int alphaBeta(int depth, int alpha, int beta, int ply);
+    int quiesce(int alpha, int beta, int ply);
+    bool checkTime();
+    bool isEasyMove(Move best, int score, int depth);
+
+    int scoreMove(Move m, Move ttMove, int ply);
+    void orderMoves(Move list[], int count, Move ttMove, int ply);
+
+public:
+    MakrukSearch();
+    void clearHash() { tt.clear(); }
+    TTStats hashStats() const { return tt.stats(); }
+    void setAbortCheck(SearchAbortCheck check, void *context);
+
+    // Find a move for the side to move within the given limits. The position
+    // is copied with its history, so repetitions of earlier game positions count.
+    // With 'resume' the table is not aged and the killers are kept, so short
+    // repeated calls on the same position (pondering in time slices) build on
+    // each other through the transposition table.
+    SearchResult search(const Position &root, const SearchLimits &limits, bool resume = false);
+
+    // Best move stored for a position by earlier searches (MOVE_NONE if unknown)
+    Move hashMove(const Position &p);
+};
+
+#endif // MAKRUK_SEARCH_H
@@ -0,0 +1,134 @@
+#include "move_recognizer.h"
+
+// ---------------------------
+// Move Recognizer Implementation
+// ---------------------------
+
+MoveRecognizer::MoveRecognizer() {
+    position = nullptr;
+    movers = 0;
+    onlyMove = MOVE_NONE;
+    threatened = 0;
+    expected = 0;
+    physical = 0;
+    vacated = 0;
+    misplaced = 0;
+    origin = -1;
+    lastPlaced = -1;
+    originTargets = 0;
+    matched = MOVE_NONE;
+    status = RECOGNIZER_SETTLED;
+}
+
+void MoveRecognizer::begin(Position *pos, Bitboard occupancy) {
+    position = pos;
+    physical = occupancy;
+    moveCache.invalidate();
+    sync(pos->bitboards().occupied);
+}
+
+void MoveRecognizer::sync(Bitboard moverSquares, Move only) {
+    const BoardBitboards &bb = position->bitboards();
+
+    expected = bb.occupied;
+    onlyMove = only;
+    if (only != MOVE_NONE) {
+        movers = squareBit(moveFrom(only));
+        threatened = squareBit(moveTo(only));
+    } else {
+        moveCache.refresh(*position);
+        movers = moverSquares & bb.occupied;
+        threatened = 0;
+        if (movers & bb.bySide[SIDE_WHITE]) threatened |= position->attacksBy(SIDE_WHITE);
+        if (movers & bb.bySide[SIDE_BLACK]) threatened |= position->attacksBy(SIDE_BLACK);
+    }
+
+    vacated = expected & ~physical;
+    origin = -1;
+    lastPlaced = -1;
+    originTargets = 0;
+    status = classify();
+}
+
+Bitboard MoveRecognizer::targetsFrom(int sq) {
+    if (onlyMove != MOVE_NONE) {
+        return (sq == moveFrom(onlyMove)) ? squareBit(moveTo(onlyMove)) : 0;
+    }
+    return moveCache.targetsFrom(sq);
+}
+
+void MoveRecognizer::selectOrigin(int sq) {
+    origin = (int8_t)sq;
+    originTargets = targetsFrom(sq);
+}
+
+RecognizerStatus MoveRecognizer::onEvent(const SensorEvent &event) {
+    Bitboard bit = squareBit(event.square);
+
+    if (event.type == SENSOR_LIFT) {
+        physical &= ~bit;
+        vacated |= bit;
+
+        // The piece taken off first may have been the victim: once the
+        // attacker comes off too, it is the one that moves
+        if (origin >= 0 && (bit & movers & expected) && !(bit & originTargets)) {
+            Bitboard targets = targetsFrom(event.square);
+            if (targets & squareBit(origin)) {
+                origin = (int8_t)event.square;
+                originTargets = targets;
+            }
+        }
+    } else {
+        physical |= bit;
+        lastPlaced = (int8_t)event.square;
+    }
+
+    status = classify();
+    return status;
+}
+
+RecognizerStatus MoveRecognizer::classify() {
+    Bitboard emptied = expected & ~physical;
+    Bitboard filled = physical & ~expected;
+    matched = MOVE_NONE;
+    misplaced = 0;
+
+    if (!emptied && !filled) {
+        vacated = 0;
+        origin = -1;
+        lastPlaced = -1;
+        originTargets = 0;
+        return RECOGNIZER_SETTLED;
+    }
+
+    if (origin >= 0 && !(emptied & squareBit(origin))) origin = -1;
+    if (origin < 0 && (emptied & movers)) selectOrigin(lsbIndex(emptied & movers));
+
+    if (origin < 0) {
+        // Nothing that may move is off: only capture victims can be waiting
+        misplaced = filled | (emptied & ~threatened);
+        return misplaced ? RECOGNIZER_MISMATCH : RECOGNIZER_LIFTED;
+    }
+
+    Bitboard originBit = squareBit(origin);
+    if (emptied == originBit) {
+        // Quiet move: the piece is down on one empty legal square
+        if (filled && !(filled & (filled - 1)) && (filled & originTargets)) {
+            matched = position->createMove(origin, lsbIndex(filled));
+            return RECOGNIZER_MOVE;
+        }
+        // Capture: the last piece down went onto a legal target that had been cleared
+        if (!filled && lastPlaced >= 0 && (squareBit(lastPlaced) & originTargets & expected & vacated)) {
+            matched = position->createMove(origin, lastPlaced);
+            return RECOGNIZER_MOVE;
+        }
+    }
+
+    misplaced = filled | (emptied & ~originBit & ~(originTargets & expected));
+    return misplaced ? RECOGNIZER_MISMATCH : RECOGNIZER_LIFTED;
+}
+
+Bitboard MoveRecognizer::getVictims() const {
+    if (origin < 0) return expected & ~physical & ~misplaced;
+    return expected & ~physical & originTargets;
+}
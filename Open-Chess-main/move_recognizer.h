@@ -0,0 +1,75 @@
+#ifndef MOVE_RECOGNIZER_H
+#define MOVE_RECOGNIZER_H
+
+#include "bitboard.h"
+#include "legal_move_cache.h"
+#include "sensor_debounce.h"
+
+// What the board shows compared with the position
+enum RecognizerStatus : uint8_t {
+    RECOGNIZER_SETTLED,     // Board matches the position
+    RECOGNIZER_LIFTED,      // Pieces are off that a legal move can still explain
+    RECOGNIZER_MOVE,        // Board shows the position after a legal move: see getMove()
+    RECOGNIZER_MISMATCH     // Some squares fit no legal move: see getMisplaced()
+};
+
+// ---------------------------
+// Move Recognizer Class
+// ---------------------------
+// Turns the stream of lift/place events into moves. The sensor occupancy is
+// kept as a bitboard and compared with the position's after every event:
+// - quiet move: only the origin emptied and one legal target filled;
+// - capture: only the origin emptied, and the last placement landed on a
+//   legal target whose piece had been taken off (victim first or attacker
+//   first, either works);
+// - a piece put back restores the occupancy, so nothing happened;
+// - a piece slid across squares only counts where the origin is empty and
+//   it rests on a legal square; squares it passes over are not moves.
+// Legal destinations come from a LegalMoveCache rebuilt by sync() when the
+// position changed, so each event costs a few bitboard operations and at
+// most two table reads: a move is confirmed by the event that completes
+// it, without waiting for the board to settle.
+class MoveRecognizer {
+private:
+    Position *position;
+    LegalMoveCache moveCache;
+    Bitboard movers;            // Pieces allowed to make the move
+    Move onlyMove;              // When set, the only move accepted
+    Bitboard threatened;        // Squares the movers could capture on (victims may come off first)
+
+    Bitboard expected;          // Occupancy of the position
+    Bitboard physical;          // Occupancy from the sensor events
+    Bitboard vacated;           // Squares seen empty since the board last matched
+    Bitboard misplaced;
+    int8_t origin;              // Square of the moving piece, -1 = none yet
+    int8_t lastPlaced;
+    Bitboard originTargets;     // Its legal destinations
+    Move matched;
+    RecognizerStatus status;
+
+    Bitboard targetsFrom(int sq);
+    void selectOrigin(int sq);
+    RecognizerStatus classify();
+
+public:
+    MoveRecognizer();
+
+    // New game: the position to follow and the occupancy the sensors see now
+    void begin(Position *pos, Bitboard occupancy);
+
+    // The position changed (a move was made) or the movers did; the physical
+    // board is kept as it is
+    void sync(Bitboard moverSquares, Move only = MOVE_NONE);
+
+    RecognizerStatus onEvent(const SensorEvent &event);
+
+    RecognizerStatus getStatus() const { return status; }
+    Move getMove() const { return matched; }
+    int getOrigin() const { return origin; }
+    Bitboard getTargets() const { return origin >= 0 ? originTargets : 0; }
+    Bitboard getVictims() const;                    // Pieces off the origin's capture squares
+    Bitboard getMisplaced() const { return misplaced; }
+    Bitboard getOccupancy() const { return physical; }
+};
+
+#endif // MOVE_RECOGNIZER_H
@@ -0,0 +1,298 @@
+#include "position.h"
+
+// Bia promote on reaching the sixth rank (row 5 for White, row 2 for Black)
+static const int PROMOTION_ROW[2] = {5, 2};
+
+static const Bitboard RANK_1 = 0xFFULL;
+static const Bitboard FILE_A = 0x0101010101010101ULL;
+
+// ---------------------------
+// Position Implementation
+// ---------------------------
+
+Position::Position() {
+    clear();
+}
+
+void Position::clear() {
+    bb.clear();
+    for (int sq = 0; sq < 64; sq++) {
+        mailbox[sq] = NO_PIECE;
+        pieceAttackSets[sq] = 0;
+    }
+    attackMap[SIDE_WHITE] = attackMap[SIDE_BLACK] = 0;
+    kingSquare[SIDE_WHITE] = kingSquare[SIDE_BLACK] = -1;
+    sideToMove = SIDE_WHITE;
+    hashKey = 0;
+    historyTop = 0;
+    historyCount = 0;
+}
+
+void Position::setFromBoard(const char board[8][8], int side) {
+    clear();
+    for (int row = 0; row < 8; row++) {
+        for (int col = 0; col < 8; col++) {
+            char piece = board[row][col];
+            if (piece == ' ') continue;
+
+            int type = pieceTypeFromChar(piece);
+            if (type == PIECE_NONE) continue;
+            putPiece(pieceSideFromChar(piece), type, squareIndex(row, col));
+        }
+    }
+    setSideToMove(side);
+
+    for (int sq = 0; sq < 64; sq++) {
+        refreshAttackSet(sq);
+    }
+    foldAttackMaps();
+}
+
+void Position::toBoard(char board[8][8]) const {
+    for (int sq = 0; sq < 64; sq++) {
+        uint8_t code = mailbox[sq];
+        board[squareRow(sq)][squareCol(sq)] =
+            (code == NO_PIECE) ? ' ' : pieceToChar(pieceCodeSide(code), pieceCodeType(code));
+    }
+}
+
+void Position::putPiece(int side, int type, int sq) {
+    Bitboard bit = squareBit(sq);
+    bb.pieces[side][type] |= bit;
+    bb.bySide[side] |= bit;
+    bb.occupied |= bit;
+    mailbox[sq] = makePieceCode(side, type);
+    hashKey ^= zobristPiece(side, type, sq);
+    if (type == PIECE_KHUN) kingSquare[side] = sq;
+}
+
+void Position::removePiece(int sq) {
+    uint8_t code = mailbox[sq];
+    int side = pieceCodeSide(code);
+    int type = pieceCodeType(code);
+    Bitboard bit = squareBit(sq);
+    bb.pieces[side][type] &= ~bit;
+    bb.bySide[side] &= ~bit;
+    bb.occupied &= ~bit;
+    mailbox[sq] = NO_PIECE;
+    hashKey ^= zobristPiece(side, type, sq);
+    if (type == PIECE_KHUN && kingSquare[side] == sq) kingSquare[side] = -1;
+}
+
+// ---------------------------
+// Incremental Attack Maps
+// ---------------------------
+
+void Position::refreshAttackSet(int sq) {
+    uint8_t code = mailbox[sq];
+    pieceAttackSets[sq] = (code == NO_PIECE)
+        ? 0
+        : pieceAttacks(pieceCodeSide(code), pieceCodeType(code), sq, bb.occupied);
+}
+
+// Only the two squares touched by the move and the Rua rays can change
+void Position::updateAttackMaps(int from, int to) {
+    refreshAttackSet(from);
+    refreshAttackSet(to);
+
+    Bitboard ruas = bb.pieces[SIDE_WHITE][PIECE_RUA] | bb.pieces[SIDE_BLACK][PIECE_RUA];
+    while (ruas) {
+        refreshAttackSet(popLsb(ruas));
+    }
+    foldAttackMaps();
+}
+
+void Position::foldAttackMaps() {
+    for (int side = 0; side < 2; side++) {
+        Bitboard map = 0;
+        Bitboard pieces = bb.bySide[side];
+        while (pieces) {
+            map |= pieceAttackSets[popLsb(pieces)];
+        }
+        attackMap[side] = map;
+    }
+}
+
+bool Position::isInCheck(int side) const {
+    int king = kingSquare[side];
+    return king >= 0 && isSquareAttacked(king, side ^ 1);
+}
+
+// ---------------------------
+// Zobrist Key
+// ---------------------------
+
+ZobristKey Position::computeHashKey() const {
+    ZobristKey key = (sideToMove == SIDE_BLACK) ? ZOBRIST_KEYS.blackToMove : 0;
+    for (int sq = 0; sq < 64; sq++) {
+        uint8_t code = mailbox[sq];
+        if (code != NO_PIECE) key ^= zobristPiece(pieceCodeSide(code), pieceCodeType(code), sq);
+    }
+    return key;
+}
+
+// ---------------------------
+// Move Application
+// ---------------------------
+
+void Position::applyMove(Move m, UndoRecord &undo) {
+    int from = moveFrom(m);
+    int to = moveTo(m);
+    uint8_t moving = mailbox[from];
+
+    undo.move = m;
+    undo.moved = moving;
+    undo.captured = mailbox[to];
+    undo.key = hashKey;
+    if (undo.captured != NO_PIECE) removePiece(to);
+
+    removePiece(from);
+    putPiece(pieceCodeSide(moving), isPromotionMove(m) ? PIECE_MET : pieceCodeType(moving), to);
+
+    sideToMove ^= 1;
+    hashKey ^= ZOBRIST_KEYS.blackToMove;
+    updateAttackMaps(from, to);
+}
+
+void Position::revertMove(const UndoRecord &undo) {
+    Move m = undo.move;
+    int from = moveFrom(m);
+    int to = moveTo(m);
+
+    removePiece(to);
+    putPiece(pieceCodeSide(undo.moved), pieceCodeType(undo.moved), from);
+    if (undo.captured != NO_PIECE) {
+        putPiece(pieceCodeSide(undo.captured), pieceCodeType(undo.captured), to);
+    }
+
+    sideToMove ^= 1;
+    hashKey = undo.key;
+    updateAttackMaps(from, to);
+}
+
+void Position::makeMove(Move m) {
+    applyMove(m, history[historyTop]);
+    historyTop = (historyTop + 1) & (POSITION_HISTORY_SIZE - 1);
+    if (historyCount < POSITION_HISTORY_SIZE) historyCount++;
+}
+
+bool Position::unmakeMove() {
+    if (historyCount == 0) return false;
+
+    historyTop = (historyTop - 1) & (POSITION_HISTORY_SIZE - 1);
+    historyCount--;
+    revertMove(history[historyTop]);
+    return true;
+}
+
+Move Position::getLastMove() const {
+    if (historyCount == 0) return MOVE_NONE;
+    return history[(historyTop - 1) & (POSITION_HISTORY_SIZE - 1)].move;
+}
+
+int Position::repetitionCount() const {
+    int count = 0;
+    int slot = historyTop;
+    for (int i = 1; i <= historyCount; i++) {
+        slot = (slot - 1) & (POSITION_HISTORY_SIZE - 1);
+        const UndoRecord &undo = history[slot];
+
+        // Positions with the same side to move are an even number of plies back
+        if ((i & 1) == 0 && undo.key == hashKey) count++;
+
+        // Nothing before a capture or a Bia move can repeat
+        if (undo.captured != NO_PIECE || pieceCodeType(undo.moved) == PIECE_BIA) break;
+    }
+    return count;
+}
+
+// Try the move without touching the undo ring
+bool Position::leavesKingSafe(Move m) {
+    int side = pieceCodeSide(mailbox[moveFrom(m)]);
+    UndoRecord undo;
+    applyMove(m, undo);
+    bool safe = !isInCheck(side);
+    revertMove(undo);
+    return safe;
+}
+
+// A piece can only be pinned by a Rua sharing its rank or file with the Khun
+bool Position::mayBePinned(int side, int sq) const {
+    int king = kingSquare[side];
+    if (king < 0) return false;
+
+    Bitboard enemyRuas = bb.pieces[side ^ 1][PIECE_RUA];
+    if (squareRow(sq) == squareRow(king) && (enemyRuas & (RANK_1 << (8 * squareRow(king))))) return true;
+    if (squareCol(sq) == squareCol(king) && (enemyRuas & (FILE_A << squareCol(king)))) return true;
+    return false;
+}
+
+// ---------------------------
+// Legal Move Generation
+// ---------------------------
+
+Move Position::createMove(int from, int to) const {
+    uint8_t code = mailbox[from];
+    if (code != NO_PIECE && pieceCodeType(code) == PIECE_BIA &&
+        squareRow(to) == PROMOTION_ROW[pieceCodeSide(code)]) {
+        return encodeMove(from, to, MOVE_FLAG_PROMOTION);
+    }
+    return encodeMove(from, to);
+}
+
+Bitboard Position::legalMovesFrom(int sq) {
+    uint8_t code = mailbox[sq];
+    if (code == NO_PIECE) return 0;
+
+    int side = pieceCodeSide(code);
+    int type = pieceCodeType(code);
+    Bitboard targets = pseudoLegalMoves(bb, side, type, sq);
+
+    // Fast path: nothing this piece does can expose its own Khun
+    if (type != PIECE_KHUN && !isInCheck(side) && !mayBePinned(side, sq)) {
+        return targets;
+    }
+
+    Bitboard legal = 0;
+    while (targets) {
+        int to = popLsb(targets);
+        if (leavesKingSafe(createMove(sq, to))) legal |= squareBit(to);
+    }
+    return legal;
+}
+
+int Position::generateLegalMoves(Move list[]) {
+    int count = 0;
+    Bitboard pieces = bb.bySide[sideToMove];
+    while (pieces) {
+        int from = popLsb(pieces);
+        Bitboard targets = legalMovesFrom(from);
+        while (targets) {
+            list[count++] = createMove(from, popLsb(targets));
+        }
+    }
+    return count;
+}
+
+bool Position::hasLegalMove() {
+    Bitboard pieces = bb.bySide[sideToMove];
+    while (pieces) {
+        if (legalMovesFrom(popLsb(pieces))) return true;
+    }
+    return false;
+}
+
+bool Position::isLegal(Move m) {
+    int from = moveFrom(m);
+    uint8_t code = mailbox[from];
+    if (code == NO_PIECE || pieceCodeSide(code) != sideToMove) return false;
+    return (legalMovesFrom(from) & squareBit(moveTo(m))) != 0;
+}
+
+bool Position::isCheckmate() {
+    return isInCheck(sideToMove) && !hasLegalMove();
+}
+
+bool Position::isStalemate() {
+    return !isInCheck(sideToMove) && !hasLegalMove();
+}
@@ -0,0 +1,123 @@
+#ifndef POSITION_H
+#define POSITION_H
+
+#include "bitboard.h"
+#include "zobrist.h"
+
+// ---------------------------
+// Move Encoding
+// ---------------------------
+// 16-bit move: bits 0-5 origin square, bits 6-11 target square, bit 12 promotion.
+typedef uint16_t Move;
+
+#define MOVE_NONE            0
+#define MOVE_FLAG_PROMOTION  0x1000
+#define MAX_MOVES            128   // Upper bound on legal moves in a Makruk position
+
+inline Move encodeMove(int from, int to, uint16_t flags = 0) { return (Move)(from | (to << 6) | flags); }
+inline int moveFrom(Move m) { return m & 0x3F; }
+inline int moveTo(Move m) { return (m >> 6) & 0x3F; }
+inline bool isPromotionMove(Move m) { return (m & MOVE_FLAG_PROMOTION) != 0; }
+
+// ---------------------------
+// Piece Codes (mailbox entries)
+// ---------------------------
+#define NO_PIECE 0xFF
+
+inline uint8_t makePieceCode(int side, int type) { return (uint8_t)((side << 3) | type); }
+inline int pieceCodeSide(uint8_t code) { return code >> 3; }
+inline int pieceCodeType(uint8_t code) { return code & 7; }
+
+// ---------------------------
+// Position Class
+// ---------------------------
+// Plies kept for unmakeMove (ring buffer: older moves are forgotten, must be a power of two)
+#define POSITION_HISTORY_SIZE 128
+
+// Bitboards plus a mailbox, with per-side attack maps that are updated
+// incrementally: a move only re-evaluates the moved/captured piece and the
+// Rua (the only sliders), so "is my Khun attacked" is a single AND.
+// The Zobrist key is kept up to date the same way by putPiece/removePiece.
+class Position {
+private:
+    BoardBitboards bb;
+    uint8_t mailbox[64];
+    int sideToMove;
+    int kingSquare[2];
+    ZobristKey hashKey;
+
+    Bitboard pieceAttackSets[64];  // Squares attacked by the piece on each square
+    Bitboard attackMap[2];         // Union of pieceAttackSets per side
+
+    // Everything needed to take a move back, kept in a fixed ring (no heap)
+    struct UndoRecord {
+        Move move;          // Includes the promotion flag
+        uint8_t moved;      // Piece code of the moving piece
+        uint8_t captured;   // Piece code on the target square, or NO_PIECE
+        ZobristKey key;     // Position key before the move
+    };
+
+    UndoRecord history[POSITION_HISTORY_SIZE];
+    int historyTop;     // Next free slot
+    int historyCount;   // Moves that can still be taken back
+
+    void putPiece(int side, int type, int sq);
+    void removePiece(int sq);
+    void refreshAttackSet(int sq);
+    void updateAttackMaps(int from, int to);
+    void foldAttackMaps();
+
+    void applyMove(Move m, UndoRecord &undo);
+    void revertMove(const UndoRecord &undo);
+    bool leavesKingSafe(Move m);
+    bool mayBePinned(int side, int sq) const;
+
+public:
+    Position();
+    void clear();
+
+    // Conversion from/to the firmware's char[8][8] boards
+    void setFromBoard(const char board[8][8], int side);
+    void toBoard(char board[8][8]) const;
+
+    int getSideToMove() const { return sideToMove; }
+    void setSideToMove(int side) {
+        if (side != sideToMove) hashKey ^= ZOBRIST_KEYS.blackToMove;
+        sideToMove = side;
+    }
+    uint8_t pieceOn(int sq) const { return mailbox[sq]; }
+    int getKingSquare(int side) const { return kingSquare[side]; }
+    const BoardBitboards &bitboards() const { return bb; }
+    Bitboard attacksBy(int side) const { return attackMap[side]; }
+
+    // Zobrist key (incremental) and a from-scratch recomputation for checking it
+    ZobristKey getHashKey() const { return hashKey; }
+    ZobristKey computeHashKey() const;
+
+    // Check detection (table lookups on the attack maps)
+    bool isSquareAttacked(int sq, int bySide) const { return (attackMap[bySide] & squareBit(sq)) != 0; }
+    bool isInCheck(int side) const;
+
+    // Legal move generation
+    Bitboard legalMovesFrom(int sq);
+    int generateLegalMoves(Move list[]);
+    bool hasLegalMove();
+    bool isLegal(Move m);       // Also requires a piece of the side to move
+    Move createMove(int from, int to) const;
+
+    // Make/unmake with the undo ring (the move must be legal)
+    void makeMove(Move m);
+    bool unmakeMove();
+    int getHistoryCount() const { return historyCount; }
+    Move getLastMove() const;
+
+    // Earlier occurrences of the current position since the last capture or
+    // Bia move (2 means threefold repetition)
+    int repetitionCount() const;
+
+    // Game end (for the side to move)
+    bool isCheckmate();
+    bool isStalemate();
+};
+
+#endif // POSITION_H
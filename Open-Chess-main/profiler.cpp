@@ -0,0 +1,139 @@
+#include "profiler.h"
+
+#if PROFILING_ENABLED
+
+static const char *const SECTION_NAMES[PROFILE_SECTION_COUNT] = {
+    "loop",
+    "scanTick",
+    "showLEDs",
+    "legalMoves",
+    "stockfishRequest",
+    "handleClient"
+};
+
+Profiler PROFILER;
+
+void profileClear(ProfileHistogram &h) {
+    h.count = 0;
+    h.minUs = 0xFFFFFFFFUL;
+    h.maxUs = 0;
+    h.totalUs = 0;
+    for (int b = 0; b < PROFILE_BUCKETS; b++) {
+        h.buckets[b] = 0;
+    }
+}
+
+void profileRecord(ProfileHistogram &h, uint32_t us) {
+    h.count++;
+    h.totalUs += us;
+    if (us < h.minUs) h.minUs = us;
+    if (us > h.maxUs) h.maxUs = us;
+
+    int bucket = (us < 2) ? 0 : 31 - __builtin_clz(us);
+    if (bucket >= PROFILE_BUCKETS) bucket = PROFILE_BUCKETS - 1;
+    h.buckets[bucket]++;
+}
+
+// ---------------------------
+// Profiler Implementation
+// ---------------------------
+
+Profiler::Profiler() {
+    reset();
+    lastReportMs = 0;
+}
+
+void Profiler::reset() {
+    for (int s = 0; s < PROFILE_SECTION_COUNT; s++) {
+        profileClear(sections[s]);
+    }
+}
+
+void Profiler::record(uint8_t section, uint32_t us) {
+    profileRecord(sections[section], us);
+}
+
+void Profiler::merge(uint8_t section, const ProfileHistogram &h) {
+    if (h.count == 0) return;
+    ProfileHistogram &total = sections[section];
+    total.count += h.count;
+    total.totalUs += h.totalUs;
+    if (h.minUs < total.minUs) total.minUs = h.minUs;
+    if (h.maxUs > total.maxUs) total.maxUs = h.maxUs;
+    for (int b = 0; b < PROFILE_BUCKETS; b++) {
+        total.buckets[b] += h.buckets[b];
+    }
+}
+
+uint32_t Profiler::percentileUs(uint8_t section, uint8_t percent) const {
+    const ProfileHistogram &h = sections[section];
+    if (h.count == 0) return 0;
+
+    // Smallest bucket with at least percent% of the samples at or below it
+    uint32_t needed = (uint32_t)(((uint64_t)h.count * percent + 99) / 100);
+    uint32_t seen = 0;
+    for (int b = 0; b < PROFILE_BUCKETS; b++) {
+        seen += h.buckets[b];
+        if (seen >= needed) {
+            uint32_t upper = (2UL << b) - 1;
+            return (upper < h.maxUs) ? upper : h.maxUs;
+        }
+    }
+    return h.maxUs;
+}
+
+uint32_t Profiler::averageUs(uint8_t section) const {
+    const ProfileHistogram &h = sections[section];
+    return h.count ? (uint32_t)(h.totalUs / h.count) : 0;
+}
+
+void Profiler::printReport() {
+    Serial.println("=== TIMING (us): count min avg p99 max ===");
+    for (int s = 0; s < PROFILE_SECTION_COUNT; s++) {
+        const ProfileHistogram &h = sections[s];
+        if (h.count == 0) continue;
+        Serial.print(SECTION_NAMES[s]);
+        Serial.print(": ");
+        Serial.print((unsigned long)h.count);
+        Serial.print(" ");
+        Serial.print((unsigned long)h.minUs);
+        Serial.print(" ");
+        Serial.print((unsigned long)averageUs(s));
+        Serial.print(" ");
+        Serial.print((unsigned long)percentileUs(s, 99));
+        Serial.print(" ");
+        Serial.println((unsigned long)h.maxUs);
+    }
+}
+
+void Profiler::maybeReport(uint32_t nowMs) {
+    if (nowMs - lastReportMs < PROFILE_REPORT_MS) return;
+    lastReportMs = nowMs;
+    printReport();
+}
+
+// {"sections":{"loop":{"count":..,"min":..,"avg":..,"p99":..,"max":..,"buckets":[..]},..}}
+String Profiler::toJson() const {
+    String json = "{\"sections\":{";
+    for (int s = 0; s < PROFILE_SECTION_COUNT; s++) {
+        const ProfileHistogram &h = sections[s];
+        if (s > 0) json += ",";
+        json += "\"";
+        json += SECTION_NAMES[s];
+        json += "\":{\"count\":" + String((unsigned long)h.count);
+        json += ",\"min\":" + String((unsigned long)(h.count ? h.minUs : 0));
+        json += ",\"avg\":" + String((unsigned long)averageUs(s));
+        json += ",\"p99\":" + String((unsigned long)percentileUs(s, 99));
+        json += ",\"max\":" + String((unsigned long)h.maxUs);
+        json += ",\"buckets\":[";
+        for (int b = 0; b < PROFILE_BUCKETS; b++) {
+            if (b > 0) json += ",";
+            json += String((unsigned long)h.buckets[b]);
+        }
+        json += "]}";
+    }
+    json += "}}";
+    return json;
+}
+
+#endif // PROFILING_ENABLED
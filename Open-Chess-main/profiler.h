@@ -0,0 +1,100 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <stdint.h>
+
+// ---------------------------
+// Profiling Configuration
+// ---------------------------
+// Off by default: PROFILE_SCOPE() and PROFILE_REPORT() then expand to
+// nothing and no tables are linked. Build with -DPROFILING_ENABLED=1 to
+// collect timings (FirmwareHost does, see its CMakeLists.txt).
+#ifndef PROFILING_ENABLED
+#define PROFILING_ENABLED 0
+#endif
+
+#define PROFILE_BUCKETS     24      // Bucket i holds [2^i, 2^(i+1)) us (bucket 0 also 0 us), up to ~16 s
+#define PROFILE_REPORT_MS   30000   // Serial report interval
+
+// Timed sections
+enum ProfileSection : uint8_t {
+    PROFILE_LOOP,                   // One scheduler pass of loop()
+    PROFILE_SCAN_TICK,              // One row read of the sensor scan (timer callback)
+    PROFILE_SHOW_LEDS,
+    PROFILE_LEGAL_MOVES,            // Legal move generation for the game modes
+    PROFILE_STOCKFISH_REQUEST,
+    PROFILE_HANDLE_CLIENT,
+    PROFILE_SECTION_COUNT
+};
+
+#if PROFILING_ENABLED
+
+#include <Arduino.h>
+
+// Fixed-size histogram: recording is a few adds and a count-leading-zeros,
+// with no allocation. Percentiles are read off the buckets, so p99 is the
+// upper edge of the bucket it falls in.
+struct ProfileHistogram {
+    uint32_t count;
+    uint32_t minUs;
+    uint32_t maxUs;
+    uint64_t totalUs;
+    uint32_t buckets[PROFILE_BUCKETS];
+};
+
+// Plain histogram updates, for code that keeps its own histogram where the
+// Profiler may not be called (the scan timer) and folds it in later
+void profileClear(ProfileHistogram &h);
+void profileRecord(ProfileHistogram &h, uint32_t us);
+
+// ---------------------------
+// Profiler Class
+// ---------------------------
+// Sections are recorded from the main loop only (core 0); nothing here is
+// safe to call from the scan timer or the engine core.
+class Profiler {
+private:
+    ProfileHistogram sections[PROFILE_SECTION_COUNT];
+    uint32_t lastReportMs;
+
+public:
+    Profiler();
+    void reset();
+
+    void record(uint8_t section, uint32_t us);
+    void merge(uint8_t section, const ProfileHistogram &h);
+    uint32_t percentileUs(uint8_t section, uint8_t percent) const;
+    uint32_t averageUs(uint8_t section) const;
+    const ProfileHistogram &getSection(uint8_t section) const { return sections[section]; }
+
+    void printReport();
+    void maybeReport(uint32_t nowMs);   // printReport() every PROFILE_REPORT_MS
+    String toJson() const;
+};
+
+extern Profiler PROFILER;
+
+// Times the enclosing scope
+class ProfileScope {
+private:
+    uint8_t section;
+    unsigned long startUs;
+
+public:
+    explicit ProfileScope(uint8_t s) : section(s), startUs(micros()) {}
+    ~ProfileScope() { PROFILER.record(section, (uint32_t)(micros() - startUs)); }
+};
+
+#define PROFILE_CONCAT_(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_(a, b)
+#define PROFILE_SCOPE(section) ProfileScope PROFILE_CONCAT(profileScope, __LINE__)(section)
+#define PROFILE_REPORT(nowMs) PROFILER.maybeReport(nowMs)
+
+#else
+
+#define PROFILE_SCOPE(section) ((void)0)
+#define PROFILE_REPORT(nowMs) ((void)0)
+
+#endif // PROFILING_ENABLED
+
+#endif // PROFILER_H
@@ -0,0 +1,56 @@
+#include "scan_transport.h"
+
+// ---------------------------
+// GPIO Transport Implementation
+// ---------------------------
+
+GpioScanTransport::GpioScanTransport(uint8_t ser, uint8_t srclk, uint8_t rclk, const int columns[8]) {
+    serPin = ser;
+    srclkPin = srclk;
+    rclkPin = rclk;
+    for (int i = 0; i < 8; i++) {
+        colPins[i] = (uint8_t)columns[i];
+    }
+}
+
+void GpioScanTransport::begin() {
+    // Setup shift register control pins
+    pinMode(serPin,   OUTPUT);
+    pinMode(srclkPin, OUTPUT);
+    pinMode(rclkPin,  OUTPUT);
+
+    // Setup column input pins
+    for (int c = 0; c < 8; c++) {
+        pinMode(colPins[c], INPUT);
+    }
+
+    // Initialize shift register to no row active
+    loadShiftRegister(0x00);
+}
+
+// The 74HC594 needs pulses of a few tens of nanoseconds; a digitalWrite()
+// call alone is longer than that, so no extra delays are needed
+void GpioScanTransport::loadShiftRegister(uint8_t data) {
+    digitalWrite(rclkPin, LOW);
+    for (int i = 0; i < 8; i++) {
+        bool bitVal = (data & (1 << i)) != 0;
+        digitalWrite(serPin, bitVal ? HIGH : LOW);
+        digitalWrite(srclkPin, HIGH);
+        digitalWrite(srclkPin, LOW);
+    }
+    digitalWrite(rclkPin, HIGH);
+    digitalWrite(rclkPin, LOW);
+}
+
+void GpioScanTransport::selectRow(int row) {
+    // Row patterns are LSB-first for the shift register
+    loadShiftRegister(row < 0 ? 0x00 : (uint8_t)(1 << row));
+}
+
+uint8_t GpioScanTransport::readColumns() {
+    uint8_t bits = 0;
+    for (int col = 0; col < 8; col++) {
+        if (digitalRead(colPins[col]) == LOW) bits |= (uint8_t)(1 << col);
+    }
+    return bits;
+}
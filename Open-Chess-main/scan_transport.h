@@ -0,0 +1,40 @@
+#ifndef SCAN_TRANSPORT_H
+#define SCAN_TRANSPORT_H
+
+#include <Arduino.h>
+
+// ---------------------------
+// Scan Transport Interface
+// ---------------------------
+// The two primitives the sensor scan needs from the hardware: drive one row
+// of the reed-switch matrix and sample the eight column inputs. SensorScanner
+// owns the timing; a transport only moves bits.
+class ScanTransport {
+public:
+    virtual ~ScanTransport() {}
+    virtual void begin() = 0;
+    virtual void selectRow(int row) = 0;    // -1 releases every row
+    virtual uint8_t readColumns() = 0;      // Bit c set = piece detected in column c
+};
+
+// ---------------------------
+// GPIO Transport
+// ---------------------------
+// Bit-banged 74HC594 for the rows, one digitalRead() per column (active LOW).
+class GpioScanTransport : public ScanTransport {
+private:
+    uint8_t serPin;
+    uint8_t srclkPin;
+    uint8_t rclkPin;
+    uint8_t colPins[8];
+
+    void loadShiftRegister(uint8_t data);
+
+public:
+    GpioScanTransport(uint8_t ser, uint8_t srclk, uint8_t rclk, const int columns[8]);
+    void begin() override;
+    void selectRow(int row) override;
+    uint8_t readColumns() override;
+};
+
+#endif // SCAN_TRANSPORT_H
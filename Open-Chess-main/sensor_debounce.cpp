@@ -0,0 +1,76 @@
+#include "sensor_debounce.h"
+
+// ---------------------------
+// Sensor Debouncer Implementation
+// ---------------------------
+
+SensorDebouncer::SensorDebouncer() {
+    stableSamples = SENSOR_DEBOUNCE_SAMPLES;
+    droppedEvents = 0;
+    stableBits = 0;
+    reset();
+}
+
+void SensorDebouncer::reset() {
+    historyIndex = 0;
+    primed = false;
+}
+
+void SensorDebouncer::setStableSamples(uint8_t samples) {
+    if (samples < 1) samples = 1;
+    if (samples > SENSOR_DEBOUNCE_MAX) samples = SENSOR_DEBOUNCE_MAX;
+    stableSamples = samples;
+
+    // Restart the window from the current stable state
+    for (int i = 0; i < SENSOR_DEBOUNCE_MAX; i++) {
+        history[i] = stableBits;
+    }
+    historyIndex = 0;
+}
+
+Bitboard SensorDebouncer::addSample(Bitboard raw, uint32_t nowMs) {
+    if (!primed) {
+        // First scan after begin(): that is the board, not a change
+        for (int i = 0; i < SENSOR_DEBOUNCE_MAX; i++) {
+            history[i] = raw;
+        }
+        stableBits = raw;
+        primed = true;
+        return stableBits;
+    }
+
+    history[historyIndex] = raw;
+    historyIndex = (uint8_t)((historyIndex + 1) % stableSamples);
+
+    Bitboard allSet = ~(Bitboard)0;
+    Bitboard anySet = 0;
+    for (int i = 0; i < stableSamples; i++) {
+        allSet &= history[i];
+        anySet |= history[i];
+    }
+
+    Bitboard next = (stableBits | allSet) & anySet;
+    Bitboard changed = next ^ stableBits;
+    stableBits = next;
+
+    // Lifts first: in a frame with both, the hand left one square before the other
+    if (changed) {
+        queueEvents(changed & ~next, SENSOR_LIFT, nowMs);
+        queueEvents(changed & next, SENSOR_PLACE, nowMs);
+    }
+    return stableBits;
+}
+
+void SensorDebouncer::queueEvents(Bitboard squares, uint8_t type, uint32_t nowMs) {
+    while (squares) {
+        SensorEvent event;
+        event.square = (uint8_t)popLsb(squares);
+        event.type = type;
+        event.timeMs = nowMs;
+        if (!events.push(event)) droppedEvents = droppedEvents + 1;
+    }
+}
+
+bool SensorDebouncer::popEvent(SensorEvent &event) {
+    return events.pop(event);
+}
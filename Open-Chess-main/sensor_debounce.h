@@ -0,0 +1,58 @@
+#ifndef SENSOR_DEBOUNCE_H
+#define SENSOR_DEBOUNCE_H
+
+#include "bitboard.h"
+#include "spsc_queue.h"
+
+// ---------------------------
+// Debounce Configuration
+// ---------------------------
+#define SENSOR_DEBOUNCE_SAMPLES   4    // Equal scans needed before a square changes (20 ms at 200 Hz)
+#define SENSOR_DEBOUNCE_MAX       8    // Upper limit for setStableSamples()
+#define SENSOR_EVENT_BUFFER_SIZE  32   // Pending lift/place events (power of two)
+
+enum SensorEventType : uint8_t {
+    SENSOR_LIFT,                // Square became empty
+    SENSOR_PLACE                // Square became occupied
+};
+
+struct SensorEvent {
+    uint8_t square;             // row * 8 + col
+    uint8_t type;               // SensorEventType
+    uint32_t timeMs;            // millis() when the change became stable
+};
+
+// ---------------------------
+// Sensor Debouncer Class
+// ---------------------------
+// Shift-register filter for all 64 squares at once: the last N raw scans
+// are kept as 64-bit words, a square turns on when it was set in all of
+// them and off when it was clear in all of them, otherwise it holds.
+// Every stable change is queued as a timestamped SensorEvent. addSample()
+// runs in the scan timer context, popEvent() in the main loop.
+class SensorDebouncer {
+private:
+    Bitboard history[SENSOR_DEBOUNCE_MAX];
+    uint8_t historyIndex;
+    uint8_t stableSamples;
+    bool primed;
+    Bitboard stableBits;
+
+    SpscQueue<SensorEvent, SENSOR_EVENT_BUFFER_SIZE> events;
+    volatile uint32_t droppedEvents;
+
+    void queueEvents(Bitboard squares, uint8_t type, uint32_t nowMs);
+
+public:
+    SensorDebouncer();
+    void reset();                               // Next sample is taken as stable, without events
+    void setStableSamples(uint8_t samples);     // 1 = no filtering
+
+    Bitboard addSample(Bitboard raw, uint32_t nowMs);   // Returns the debounced occupancy
+    Bitboard stable() const { return stableBits; }
+
+    bool popEvent(SensorEvent &event);
+    uint32_t getDroppedEvents() const { return droppedEvents; }
+};
+
+#endif // SENSOR_DEBOUNCE_H
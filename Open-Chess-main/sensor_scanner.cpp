@@ -0,0 +1,141 @@
+#include "sensor_scanner.h"
+
+#define SCAN_IDLE 8     // scanRow between frames
+
+// ---------------------------
+// Sensor Scanner Implementation
+// ---------------------------
+
+SensorScanner::SensorScanner(ScanTransport *t) : transport(t) {
+    timerDriven = false;
+    scanRow = SCAN_IDLE;
+    rowSelectedAt = 0;
+    frameStartedAt = 0;
+    scanPeriodUs = SENSOR_SCAN_PERIOD_US;
+    scanBits = 0;
+    rawFrameBits = 0;
+    frameBits = 0;
+    frameCount = 0;
+#if PROFILING_ENABLED
+    profileClear(tickTiming);
+#endif
+}
+
+void SensorScanner::begin(bool useTimer) {
+    transport->begin();
+    scanRow = SCAN_IDLE;
+    frameStartedAt = micros() - scanPeriodUs;  // First frame starts on the first tick
+    debouncer.reset();
+    timerDriven = useTimer;
+    if (!timerDriven) return;
+
+#if defined(ARDUINO_ARCH_RP2040)
+    // Negative delay: the period is measured from callback start to callback start
+    add_repeating_timer_us(-SENSOR_ROW_SETTLE_US, scanTimerCallback, this, &scanTimer);
+#elif defined(FIRMWARE_HOST)
+    // Stand-in for the timer interrupt; noInterrupts() holds it off the same way
+    std::thread([this] {
+        while (true) {
+            noInterrupts();
+            tick(micros());
+            interrupts();
+            std::this_thread::sleep_for(std::chrono::microseconds(SENSOR_ROW_SETTLE_US));
+        }
+    }).detach();
+#endif
+}
+
+#if defined(ARDUINO_ARCH_RP2040)
+bool SensorScanner::scanTimerCallback(repeating_timer_t *timer) {
+    ((SensorScanner *)timer->user_data)->tick(micros());
+    return true;  // Keep repeating
+}
+#endif
+
+bool SensorScanner::tick(unsigned long nowUs) {
+    if (scanRow == SCAN_IDLE) {
+        // Between frames: start the next one when the period is up
+        if (nowUs - frameStartedAt < scanPeriodUs) return false;
+        frameStartedAt = nowUs;
+        scanBits = 0;
+        scanRow = 0;
+        transport->selectRow(0);
+        rowSelectedAt = nowUs;
+        return false;
+    }
+
+    if (nowUs - rowSelectedAt < SENSOR_ROW_SETTLE_US) return false;
+
+#if PROFILING_ENABLED
+    unsigned long startUs = micros();   // Only ticks that read a row are timed
+#endif
+    scanBits |= (Bitboard)transport->readColumns() << (scanRow * 8);
+
+    if (++scanRow < SCAN_IDLE) {
+        transport->selectRow(scanRow);
+        rowSelectedAt = nowUs;
+#if PROFILING_ENABLED
+        profileRecord(tickTiming, (uint32_t)(micros() - startUs));
+#endif
+        return false;
+    }
+
+    // Frame complete: release the rows, filter and publish it
+    transport->selectRow(-1);
+    rawFrameBits = scanBits;
+    frameBits = debouncer.addSample(scanBits, millis());
+    frameCount = frameCount + 1;
+#if PROFILING_ENABLED
+    profileRecord(tickTiming, (uint32_t)(micros() - startUs));
+#endif
+    return true;
+}
+
+Bitboard SensorScanner::latestFrame() {
+    if (!timerDriven) {
+        tick(micros());
+        return frameBits;
+    }
+
+    // A 64-bit copy is not atomic on the Cortex-M0+
+    noInterrupts();
+    Bitboard bits = frameBits;
+    interrupts();
+    return bits;
+}
+
+Bitboard SensorScanner::latestRawFrame() {
+    if (!timerDriven) return rawFrameBits;
+
+    noInterrupts();
+    Bitboard bits = rawFrameBits;
+    interrupts();
+    return bits;
+}
+
+bool SensorScanner::popEvent(SensorEvent &event) {
+    if (!timerDriven) tick(micros());
+    return debouncer.popEvent(event);
+}
+
+void SensorScanner::setDebounceSamples(uint8_t samples) {
+    if (timerDriven) noInterrupts();
+    debouncer.setStableSamples(samples);
+    if (timerDriven) interrupts();
+}
+
+void SensorScanner::waitForFrame() {
+    uint32_t start = frameCount;
+    while (frameCount == start) {
+        if (!timerDriven) tick(micros());
+    }
+}
+
+#if PROFILING_ENABLED
+void SensorScanner::takeTickTiming(ProfileHistogram &out) {
+    if (timerDriven) noInterrupts();
+    out = tickTiming;
+    profileClear(tickTiming);
+    if (timerDriven) interrupts();
+}
+#endif
@@ -0,0 +1,81 @@
+#ifndef SENSOR_SCANNER_H
+#define SENSOR_SCANNER_H
+
+#include "bitboard.h"
+#include "scan_transport.h"
+#include "sensor_debounce.h"
+#include "profiler.h"
+
+// ---------------------------
+// Sensor Scan Timing
+// ---------------------------
+// The matrix is scanned one row per tick: a tick reads the row selected on
+// the previous tick and selects the next one, so the settle time is spent
+// outside the driver instead of in delayMicroseconds().
+#define SENSOR_ROW_SETTLE_US   100    // Row select to column read
+#define SENSOR_SCAN_PERIOD_US  5000   // Default start-to-start time of full scans (200 Hz)
+
+// On the RP2040 a repeating timer callback ticks the scan, in FirmwareHost a
+// thread stands in for it. Elsewhere readSensors() ticks it from the main loop.
+#if defined(ARDUINO_ARCH_RP2040) || defined(FIRMWARE_HOST)
+#define SENSOR_SCAN_TIMER 1
+#else
+#define SENSOR_SCAN_TIMER 0
+#endif
+
+// ---------------------------
+// Sensor Scanner Class
+// ---------------------------
+// Row-per-tick state machine on top of a ScanTransport. Complete frames are
+// published as one 64-bit word (bit = row * 8 + col), after the debouncer
+// has filtered them and queued the lift/place events.
+class SensorScanner {
+private:
+    ScanTransport *transport;
+    bool timerDriven;
+
+    uint8_t scanRow;            // Row settling since rowSelectedAt, or 8 between frames
+    unsigned long rowSelectedAt;
+    unsigned long frameStartedAt;
+    unsigned long scanPeriodUs;
+    Bitboard scanBits;          // Frame under construction
+    volatile Bitboard rawFrameBits;     // Last complete frame as scanned
+    volatile Bitboard frameBits;        // The same, debounced
+    SensorDebouncer debouncer;
+    volatile uint32_t frameCount;
+#if PROFILING_ENABLED
+    ProfileHistogram tickTiming;        // Row reads since the last takeTickTiming()
+#endif
+
+#if defined(ARDUINO_ARCH_RP2040)
+    repeating_timer_t scanTimer;
+    static bool scanTimerCallback(repeating_timer_t *timer);
+#endif
+
+public:
+    explicit SensorScanner(ScanTransport *t);
+    void setTransport(ScanTransport *t) { transport = t; }     // Before begin()
+    void begin(bool useTimer = SENSOR_SCAN_TIMER);
+
+    bool tick(unsigned long nowUs);     // Advance by at most one row; true when a frame completed
+    void poll() { if (!timerDriven) tick(micros()); }   // From the main loop; no-op when timer-driven
+    Bitboard latestFrame();             // Debounced; never waits for the scan
+    Bitboard latestRawFrame();
+    void waitForFrame();                // Block until the next complete frame
+
+    void setScanPeriod(unsigned long us) { scanPeriodUs = us; }
+    uint32_t getFrameCount() const { return frameCount; }
+
+    // Debounced changes, oldest first
+    bool popEvent(SensorEvent &event);
+    void setDebounceSamples(uint8_t samples);
+    uint32_t getDroppedEvents() const { return debouncer.getDroppedEvents(); }
+
+#if PROFILING_ENABLED
+    // The tick timings are kept here because the Profiler may not be called
+    // from the timer: the main loop copies them out and folds them in
+    void takeTickTiming(ProfileHistogram &out);
+#endif
+};
+
+#endif // SENSOR_SCANNER_H
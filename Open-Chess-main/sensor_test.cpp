@@ -14,6 +14,8 @@ const char SensorTest::INITIAL_BOARD[8][8] = {
 };
 
 SensorTest::SensorTest(BoardDriver* bd) : boardDriver(bd) {
+    occupied = 0;
+    displayDirty = true;
 }
 
 void SensorTest::begin() {
@@ -22,36 +24,45 @@ void SensorTest::begin() {
     Serial.println("This mode continuously displays detected pieces.");
     
     boardDriver->clearAllLEDs();
+
+    // Start from the current board, then follow the events
+    boardDriver->flushSensorEvents();
+    boardDriver->readSensors();
+    occupied = boardDriver->getSensorBits();
+    displayDirty = true;
 }
 
 void SensorTest::update() {
-    // Read current sensor state
-    boardDriver->readSensors();
-    
-    // Clear all LEDs first
-    boardDriver->clearAllLEDs();
-    
-    // Light up squares where pieces are detected
-    for (int row = 0; row < 8; row++) {
-        for (int col = 0; col < 8; col++) {
-            if (boardDriver->getSensorState(row, col)) {
-                // Light up detected pieces in white
-                boardDriver->setSquareLED(row, col, 0, 0, 0, 255);
-            }
+    // Apply the lifts and placements since the last update
+    SensorEvent event;
+    while (boardDriver->pollSensorEvent(event)) {
+        Bitboard bit = squareBit(event.square);
+        occupied = (event.type == SENSOR_PLACE) ? (occupied | bit) : (occupied & ~bit);
+        displayDirty = true;
+    }
+
+    // Redraw only when something changed
+    if (displayDirty) {
+        boardDriver->clearAllLEDs();
+
+        // Light up squares where pieces are detected (white)
+        Bitboard pieces = occupied;
+        while (pieces) {
+            int sq = popLsb(pieces);
+            boardDriver->setSquareLED(squareRow(sq), squareCol(sq), LED_SENSOR);
         }
+
+        boardDriver->showLEDs();
+        displayDirty = false;
     }
     
-    // Show the updated LED state
-    boardDriver->showLEDs();
-    
     // Print board state periodically for debugging
     static unsigned long lastPrint = 0;
     if (millis() - lastPrint > 2000) { // Print every 2 seconds
+        boardDriver->readSensors();
         boardDriver->printBoardState(INITIAL_BOARD);
         lastPrint = millis();
     }
-    
-    delay(100); // Small delay to prevent overwhelming the system
 }
 
 bool SensorTest::isActive() {
@@ -60,5 +71,6 @@ bool SensorTest::isActive() {
 
 void SensorTest::reset() {
     boardDriver->clearAllLEDs();
+    boardDriver->showLEDs();
     Serial.println("Sensor test reset - ready for testing!");
 }
\ No newline at end of file
@@ -13,6 +13,10 @@ private:
     // Expected initial configuration for testing
     static const char INITIAL_BOARD[8][8];
 
+    // Occupancy as reported by the sensor events
+    Bitboard occupied;
+    bool displayDirty;
+
 public:
     SensorTest(BoardDriver* bd);
     void begin();
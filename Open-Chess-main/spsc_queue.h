@@ -0,0 +1,48 @@
+#ifndef SPSC_QUEUE_H
+#define SPSC_QUEUE_H
+
+#include <stdint.h>
+#include <atomic>
+
+// ---------------------------
+// Single-Producer Single-Consumer Queue
+// ---------------------------
+// Lock-free ring buffer for handing data between the two RP2040 cores (or
+// two host threads). Exactly one side may call push() and exactly one side
+// pop(). Capacity must be a power of two; the indices run freely and wrap.
+template <typename T, uint32_t Capacity>
+class SpscQueue {
+    static_assert((Capacity & (Capacity - 1)) == 0, "SpscQueue capacity must be a power of two");
+
+private:
+    T items[Capacity];
+    std::atomic<uint32_t> head;   // Next slot to read (written by the consumer)
+    std::atomic<uint32_t> tail;   // Next slot to write (written by the producer)
+
+public:
+    SpscQueue() : head(0), tail(0) {}
+
+    // Producer side
+    bool push(const T &item) {
+        uint32_t t = tail.load(std::memory_order_relaxed);
+        if (t - head.load(std::memory_order_acquire) == Capacity) return false;  // Full
+        items[t & (Capacity - 1)] = item;
+        tail.store(t + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer side
+    bool pop(T &item) {
+        uint32_t h = head.load(std::memory_order_relaxed);
+        if (h == tail.load(std::memory_order_acquire)) return false;  // Empty
+        item = items[h & (Capacity - 1)];
+        head.store(h + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool empty() const {
+        return head.load(std::memory_order_acquire) == tail.load(std::memory_order_acquire);
+    }
+};
+
+#endif // SPSC_QUEUE_H
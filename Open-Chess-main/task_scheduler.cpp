@@ -0,0 +1,90 @@
+#include "task_scheduler.h"
+#include <Arduino.h>
+
+// ---------------------------
+// Task Scheduler Implementation
+// ---------------------------
+
+TaskScheduler::TaskScheduler() {
+    taskCount = 0;
+}
+
+int TaskScheduler::addTask(const char *name, TaskFunction run, uint32_t periodMs, uint32_t budgetUs) {
+    if (taskCount >= SCHEDULER_MAX_TASKS) return -1;
+
+    SchedulerTask &task = tasks[taskCount];
+    task.name = name;
+    task.run = run;
+    task.periodMs = periodMs;
+    task.budgetUs = budgetUs;
+    task.lastRunMs = millis() - periodMs;   // Due on the first pass
+    task.lastUs = 0;
+    task.maxUs = 0;
+    task.runs = 0;
+    task.overruns = 0;
+    task.unreportedOverruns = 0;
+    task.lastReportMs = 0;
+    task.enabled = true;
+    return taskCount++;
+}
+
+void TaskScheduler::setEnabled(int task, bool enabled) {
+    if (task >= 0 && task < taskCount) tasks[task].enabled = enabled;
+}
+
+int TaskScheduler::run(uint32_t nowMs) {
+    int ran = 0;
+    for (int i = 0; i < taskCount; i++) {
+        SchedulerTask &task = tasks[i];
+        if (!task.enabled || nowMs - task.lastRunMs < task.periodMs) continue;
+
+        // Keep the period grid; after a long stall start again from now
+        task.lastRunMs = (nowMs - task.lastRunMs < 2 * task.periodMs) ? task.lastRunMs + task.periodMs : nowMs;
+
+        unsigned long startUs = micros();
+        task.run(nowMs);
+        uint32_t elapsedUs = micros() - startUs;
+
+        task.lastUs = elapsedUs;
+        if (elapsedUs > task.maxUs) task.maxUs = elapsedUs;
+        task.runs++;
+        ran++;
+
+        if (elapsedUs > task.budgetUs) {
+            task.overruns++;
+            task.unreportedOverruns++;
+            reportOverrun(task, millis());
+        }
+    }
+    return ran;
+}
+
+void TaskScheduler::reportOverrun(SchedulerTask &task, uint32_t nowMs) {
+    if (task.lastReportMs != 0 && nowMs - task.lastReportMs < SCHEDULER_OVERRUN_LOG_MS) return;
+
+    Serial.print("Scheduler: task '");
+    Serial.print(task.name);
+    Serial.print("' took ");
+    Serial.print((unsigned long)task.lastUs);
+    Serial.print(" us (budget ");
+    Serial.print((unsigned long)task.budgetUs);
+    Serial.print(" us), overruns: ");
+    Serial.println((unsigned long)task.unreportedOverruns);
+
+    task.unreportedOverruns = 0;
+    task.lastReportMs = nowMs;
+}
+
+void TaskScheduler::printStats() {
+    Serial.println("=== SCHEDULER TASKS ===");
+    for (int i = 0; i < taskCount; i++) {
+        const SchedulerTask &task = tasks[i];
+        Serial.print(task.name);
+        Serial.print(": runs ");
+        Serial.print((unsigned long)task.runs);
+        Serial.print(", max ");
+        Serial.print((unsigned long)task.maxUs);
+        Serial.print(" us, overruns ");
+        Serial.println((unsigned long)task.overruns);
+    }
+}
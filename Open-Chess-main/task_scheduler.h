@@ -0,0 +1,59 @@
+#ifndef TASK_SCHEDULER_H
+#define TASK_SCHEDULER_H
+
+#include <stdint.h>
+
+// ---------------------------
+// Scheduler Configuration
+// ---------------------------
+#define SCHEDULER_MAX_TASKS        8
+#define SCHEDULER_OVERRUN_LOG_MS   1000  // Overrun reports per task, at most one per interval
+
+typedef void (*TaskFunction)(uint32_t nowMs);
+
+struct SchedulerTask {
+    const char *name;
+    TaskFunction run;
+    uint32_t periodMs;          // 0 = every pass
+    uint32_t budgetUs;          // Longer runs are overruns
+    uint32_t lastRunMs;
+    uint32_t lastUs;            // Duration of the last run
+    uint32_t maxUs;
+    uint32_t runs;
+    uint32_t overruns;
+    uint32_t unreportedOverruns;
+    uint32_t lastReportMs;
+    bool enabled;
+};
+
+// ---------------------------
+// Task Scheduler Class
+// ---------------------------
+// Fixed-priority cooperative scheduler for loop(): tasks are checked in the
+// order they were added (first = highest priority) and each due task runs
+// to completion. Every run is timed with micros(); a run over its budget is
+// counted and reported on Serial, so a subsystem that holds on to the CPU
+// shows up by name instead of as a sluggish board.
+class TaskScheduler {
+private:
+    SchedulerTask tasks[SCHEDULER_MAX_TASKS];
+    uint8_t taskCount;
+
+    void reportOverrun(SchedulerTask &task, uint32_t nowMs);
+
+public:
+    TaskScheduler();
+
+    // Returns the task index, or -1 when the table is full
+    int addTask(const char *name, TaskFunction run, uint32_t periodMs, uint32_t budgetUs);
+    void setEnabled(int task, bool enabled);
+
+    // One pass over the table; returns the number of tasks that ran
+    int run(uint32_t nowMs);
+
+    int getTaskCount() const { return taskCount; }
+    const SchedulerTask &getTask(int task) const { return tasks[task]; }
+    void printStats();
+};
+
+#endif // TASK_SCHEDULER_H
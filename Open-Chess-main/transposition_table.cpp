@@ -0,0 +1,140 @@
+#include "transposition_table.h"
+#include <Arduino.h>
+
+// ---------------------------
+// Transposition Table Implementation
+// ---------------------------
+
+TranspositionTable::TranspositionTable() {
+    clear();
+}
+
+void TranspositionTable::clear() {
+    for (size_t i = 0; i < BUCKET_COUNT; i++) {
+        for (int j = 0; j < TT_BUCKET_ENTRIES; j++) {
+            TTEntry &entry = buckets[i].entries[j];
+            entry.keyFragment = 0;
+            entry.move = MOVE_NONE;
+            entry.score = 0;
+            entry.depth = 0;
+            entry.genBound = TT_BOUND_NONE;
+        }
+    }
+    generation = 0;
+    resetStats();
+}
+
+void TranspositionTable::newSearch() {
+    generation = (generation + 1) & 0x3F;
+}
+
+const TTEntry *TranspositionTable::probe(ZobristKey key) {
+    probes++;
+    TTBucket &bucket = bucketFor(key);
+    uint16_t fragment = fragmentOf(key);
+
+    for (int i = 0; i < TT_BUCKET_ENTRIES; i++) {
+        TTEntry &entry = bucket.entries[i];
+        if (entry.bound() != TT_BOUND_NONE && entry.keyFragment == fragment) {
+            entry.genBound = (uint8_t)((generation << 2) | entry.bound());  // Still useful: refresh its age
+            hits++;
+            return &entry;
+        }
+    }
+    return nullptr;
+}
+
+void TranspositionTable::store(ZobristKey key, Move move, int score, int depth, uint8_t bound) {
+    TTBucket &bucket = bucketFor(key);
+    uint16_t fragment = fragmentOf(key);
+
+    // Same position: overwrite unless a much deeper result would be lost
+    TTEntry *target = nullptr;
+    for (int i = 0; i < TT_BUCKET_ENTRIES; i++) {
+        TTEntry &entry = bucket.entries[i];
+        if (entry.bound() != TT_BOUND_NONE && entry.keyFragment == fragment) {
+            if (bound != TT_BOUND_EXACT && depth + 2 < entry.depth) {
+                if (entry.move == MOVE_NONE) entry.move = move;
+                return;
+            }
+            target = &entry;
+            break;
+        }
+    }
+
+    // Otherwise replace the shallowest entry, treating entries from older
+    // searches as 8 plies shallower than they are
+    if (!target) {
+        int worst = 0x7FFF;
+        for (int i = 0; i < TT_BUCKET_ENTRIES; i++) {
+            TTEntry &entry = bucket.entries[i];
+            if (entry.bound() == TT_BOUND_NONE) {
+                target = &entry;
+                break;
+            }
+            int value = entry.depth - ((entry.generation() != generation) ? 8 : 0);
+            if (value < worst) {
+                worst = value;
+                target = &entry;
+            }
+        }
+        if (target->bound() != TT_BOUND_NONE && target->generation() == generation) collisions++;
+    }
+
+    // Keep the old best move if the new result has none
+    if (move != MOVE_NONE || target->keyFragment != fragment) target->move = move;
+    target->keyFragment = fragment;
+    target->score = (int16_t)score;
+    target->depth = (int8_t)depth;
+    target->genBound = (uint8_t)((generation << 2) | bound);
+}
+
+int TranspositionTable::permilleUsed() const {
+    // The first 250 buckets are a fair sample of the whole table
+    int sampled = 0;
+    int used = 0;
+    for (size_t i = 0; i < BUCKET_COUNT && i < 250; i++) {
+        for (int j = 0; j < TT_BUCKET_ENTRIES; j++) {
+            const TTEntry &entry = buckets[i].entries[j];
+            if (entry.bound() != TT_BOUND_NONE && entry.generation() == generation) used++;
+            sampled++;
+        }
+    }
+    return sampled ? used * 1000 / sampled : 0;
+}
+
+// ---------------------------
+// Statistics
+// ---------------------------
+
+void TranspositionTable::resetStats() {
+    probes = 0;
+    hits = 0;
+    collisions = 0;
+}
+
+TTStats TranspositionTable::stats() const {
+    TTStats s;
+    s.sizeBytes = (unsigned long)sizeBytes();
+    s.probes = probes;
+    s.hits = hits;
+    s.collisions = collisions;
+    s.permilleUsed = permilleUsed();
+    return s;
+}
+
+void printTTStats(const TTStats &stats) {
+    Serial.print("TT ");
+    Serial.print(stats.sizeBytes / 1024);
+    Serial.print(" KB: ");
+    Serial.print(stats.probes);
+    Serial.print(" probes, ");
+    Serial.print(stats.hits);
+    Serial.print(" hits, ");
+    Serial.print(stats.probes - stats.hits);
+    Serial.print(" misses, ");
+    Serial.print(stats.collisions);
+    Serial.print(" collisions, ");
+    Serial.print(stats.permilleUsed);
+    Serial.println(" permille used");
+}
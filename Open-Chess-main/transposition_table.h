@@ -0,0 +1,98 @@
+#ifndef TRANSPOSITION_TABLE_H
+#define TRANSPOSITION_TABLE_H
+
+#include "position.h"
+#include <stddef.h>
+
+// ---------------------------
+// Table Size
+// ---------------------------
+// Byte budget for the table. 32 KB fits next to the NeoPixel buffer and the
+// WiFi stack on the RP2040; host builds override it on the compiler command
+// line (see emulator_project/firmware_host/CMakeLists.txt).
+#ifndef TT_SIZE_BYTES
+#define TT_SIZE_BYTES 32768
+#endif
+
+#define TT_BUCKET_ENTRIES 4   // Entries sharing one index (one 32-byte bucket)
+
+enum TTBound : uint8_t {
+    TT_BOUND_NONE = 0,
+    TT_BOUND_EXACT = 1,
+    TT_BOUND_LOWER = 2,       // Fail high: score is at least this
+    TT_BOUND_UPPER = 3        // Fail low: score is at most this
+};
+
+// 8-byte packed entry. The low key bits select the bucket, the top 16 bits
+// are kept to tell positions sharing a bucket apart.
+struct TTEntry {
+    uint16_t keyFragment;
+    Move move;
+    int16_t score;
+    int8_t depth;
+    uint8_t genBound;         // Search generation (bits 2-7) and TTBound (bits 0-1)
+
+    uint8_t bound() const { return genBound & 3; }
+    uint8_t generation() const { return genBound >> 2; }
+};
+
+struct TTBucket {
+    TTEntry entries[TT_BUCKET_ENTRIES];
+};
+
+// Largest power-of-two bucket count that fits the byte budget
+constexpr size_t ttBucketCount(size_t bytes) {
+    size_t count = 1;
+    while (count * 2 * sizeof(TTBucket) <= bytes) count *= 2;
+    return count;
+}
+
+// Usage counters, copied out so they can be printed on another core
+struct TTStats {
+    unsigned long sizeBytes;
+    unsigned long probes;
+    unsigned long hits;
+    unsigned long collisions;   // Stores that evicted another current-search position
+    int permilleUsed;           // Sampled share of entries written by this search
+};
+
+void printTTStats(const TTStats &stats);
+
+// ---------------------------
+// Transposition Table Class
+// ---------------------------
+// Fixed-size, statically allocated hash table of search results. Within a
+// bucket the replacement is depth-preferred: the shallowest entry (entries
+// from earlier searches count as shallower) makes room for the new one.
+class TranspositionTable {
+public:
+    static constexpr size_t BUCKET_COUNT = ttBucketCount(TT_SIZE_BYTES);
+
+private:
+    TTBucket buckets[BUCKET_COUNT];
+    uint8_t generation;
+
+    // Usage counters (reset with resetStats)
+    unsigned long probes;
+    unsigned long hits;
+    unsigned long collisions;   // Stores that evicted another current-search position
+
+    TTBucket &bucketFor(ZobristKey key) { return buckets[key & (BUCKET_COUNT - 1)]; }
+    static uint16_t fragmentOf(ZobristKey key) { return (uint16_t)(key >> 48); }
+
+public:
+    TranspositionTable();
+    void clear();
+    void newSearch();           // Ages existing entries so they are replaced first
+
+    const TTEntry *probe(ZobristKey key);
+    void store(ZobristKey key, Move move, int score, int depth, uint8_t bound);
+
+    size_t sizeBytes() const { return sizeof(buckets); }
+    int permilleUsed() const;   // Sampled share of entries written by this search
+
+    void resetStats();
+    TTStats stats() const;
+};
+
+#endif // TRANSPOSITION_TABLE_H
@@ -1,5 +1,6 @@
 #include "wifi_manager.h"
 #include <Arduino.h>
+#include "profiler.h"
 
 WiFiManager::WiFiManager() : server(AP_PORT) {
     apMode = true;
@@ -9,6 +10,7 @@ WiFiManager::WiFiManager() : server(AP_PORT) {
     lichessToken = "";
     gameMode = "None";
     startupType = "WiFi";
+    takeBackRequested = false;
 }
 
 void WiFiManager::begin() {
@@ -188,6 +190,14 @@ void WiFiManager::handleClient() {
             String webpage = generateWebPage();
             sendResponse(client, webpage);
         }
+        else if (request.indexOf("GET /stats") >= 0) {
+            // Timing histograms (see profiler.h)
+#if PROFILING_ENABLED
+            sendResponse(client, PROFILER.toJson(), "application/json");
+#else
+            sendResponse(client, R"({"profiling":false})", "application/json");
+#endif
+        }
         else if (request.indexOf("GET /game") >= 0) {
             // Game selection page
             String gameSelectionPage = generateGameSelectionPage();
@@ -209,6 +219,12 @@ void WiFiManager::handleClient() {
             // Game selection submission
             handleGameSelection(client, body);
         }
+        else if (request.indexOf("POST /takeback") >= 0) {
+            // Undo the last move: picked up by the main loop
+            Serial.println("Take back requested via web");
+            takeBackRequested = true;
+            sendResponse(client, R"({"status":"success","message":"Take back requested"})", "application/json");
+        }
         else {
             // 404 Not Found
             String response = "<html><body style='font-family:Arial;background:#5c5d5e;color:#ec8703;text-align:center;padding:50px;'>";
@@ -368,6 +384,7 @@ String WiFiManager::generateGameSelectionPage() {
     html += "</div>";
     
     html += "</div>";
+    html += "<button class=\"back-button\" onclick=\"takeBack()\">Take Back Move</button>";
     html += "<a href=\"/\" class=\"back-button\">Back to Configuration</a>";
     html += "</div>";
     
@@ -380,6 +397,12 @@ String WiFiManager::generateGameSelectionPage() {
     html += ".catch(error => { console.error('Error:', error); });";
     html += "} else { alert('This game mode is coming soon!'); }";
     html += "}";
+    html += "function takeBack() {";
+    html += "fetch('/takeback', { method: 'POST' })";
+    html += ".then(response => response.text())";
+    html += ".then(data => { alert('Take back requested! Put the pieces back as shown on the board.'); })";
+    html += ".catch(error => { console.error('Error:', error); });";
+    html += "}";
     html += "</script>";
     html += "</body>";
     html += "</html>";
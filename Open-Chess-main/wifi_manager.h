@@ -26,6 +26,7 @@ private:
     String lichessToken;
     String gameMode;
     String startupType;
+    bool takeBackRequested;
     
     // Web interface methods
     String generateWebPage();
@@ -51,6 +52,10 @@ public:
     // Game selection via web
     int getSelectedGameMode();
     void resetGameSelection();
+    
+    // Take back the last move (Chess Moves mode)
+    bool isTakeBackRequested() { return takeBackRequested; }
+    void resetTakeBack() { takeBackRequested = false; }
 };
 
 #endif // WIFI_MANAGER_H
\ No newline at end of file
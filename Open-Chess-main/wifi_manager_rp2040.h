@@ -30,6 +30,10 @@ public:
     // Game selection via web
     int getSelectedGameMode();
     void resetGameSelection();
+    
+    // Take back the last move (Chess Moves mode)
+    bool isTakeBackRequested() { return false; }
+    void resetTakeBack() {}
 };
 
 #endif // WIFI_MANAGER_RP2040_H
\ No newline at end of file
@@ -0,0 +1,33 @@
+#include "zobrist.h"
+
+// ---------------------------
+// Compile-time Key Generation
+// ---------------------------
+
+namespace {
+
+// splitmix64 step: well mixed and fully defined on every platform
+constexpr uint64_t splitMix64(uint64_t &state) {
+    uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+constexpr ZobristTables buildZobristTables() {
+    ZobristTables t{};
+    uint64_t state = ZOBRIST_SEED;
+    for (int side = 0; side < 2; side++) {
+        for (int type = 0; type < PIECE_TYPE_COUNT; type++) {
+            for (int sq = 0; sq < 64; sq++) {
+                t.piece[side][type][sq] = splitMix64(state);
+            }
+        }
+    }
+    t.blackToMove = splitMix64(state);
+    return t;
+}
+
+} // namespace
+
+extern constexpr ZobristTables ZOBRIST_KEYS = buildZobristTables();
@@ -0,0 +1,26 @@
+#ifndef ZOBRIST_H
+#define ZOBRIST_H
+
+#include "bitboard.h"
+
+// ---------------------------
+// Zobrist Keys
+// ---------------------------
+// 64-bit position keys: XOR of one key per (side, piece type, square) plus
+// the side-to-move key when Black is to move. The tables are generated at
+// compile time from a fixed seed with integer-only arithmetic, so the RP2040
+// firmware and the host builds produce identical keys.
+typedef uint64_t ZobristKey;
+
+#define ZOBRIST_SEED 0x4D616B72756B3634ULL  // "Makruk64"
+
+struct ZobristTables {
+    ZobristKey piece[2][PIECE_TYPE_COUNT][64];
+    ZobristKey blackToMove;
+};
+
+extern const ZobristTables ZOBRIST_KEYS;
+
+inline ZobristKey zobristPiece(int side, int type, int sq) { return ZOBRIST_KEYS.piece[side][type][sq]; }
+
+#endif // ZOBRIST_H